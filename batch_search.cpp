@@ -0,0 +1,135 @@
+#include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+
+#include "ply_to_embedding.h"
+#include "make_cc.h"
+#include "edgecode.h"
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "trail_pipeline.h"
+#include "td_covering_tree.h"
+#include "estimate_covering_tree.h"
+#include "find_a_trail.h"
+#include "batch_search.h"
+
+using namespace std;
+
+/*
+ * Reads a batch manifest: one mesh per line, "<input_PLY_file> [<given_shape_name>] [<timeout_seconds>]"
+ * (blank lines and lines starting with "#" skipped). The shape name defaults to the file name without its
+ * extension.
+ *
+ * @param manifest Manifest file
+ * @param timeout Seconds of search of each mesh not given its own (0 for none)
+ * @param meshes Meshes listed
+ * @return int Number of meshes listed (-1 if the manifest cannot be read)
+ */
+int read_manifest(string manifest, double timeout, deque<Batch_Mesh>& meshes) {
+    ifstream myFile(manifest);
+    if (!myFile.is_open()) {
+        return -1;
+    } //endif
+    string line;
+    while (getline(myFile, line)) {
+        istringstream stream(line);
+        string file_name, shape;
+        if (!(stream >> file_name) || file_name[0] == '#') {
+            continue;
+        } //endif
+        Batch_Mesh& mesh = meshes.emplace_back();
+        mesh.file_name = file_name;
+        mesh.shape = stream >> shape ? shape : filesystem::path(file_name).stem().string();
+        if (!(stream >> mesh.timeout)) mesh.timeout = timeout;
+    } //endwhile
+    myFile.close();
+    return meshes.size();
+}
+
+/*
+ * Reads a mesh of a batch and reduces its covering tree searches as a single run would, without console output
+ * (branching order with the smallest estimated search for the branch-bound search)
+ *
+ * @param mesh Mesh (file name set)
+ * @param options Covering tree search engine and its settings
+ * @return bool Whether or not the mesh was read
+ */
+bool prepare_mesh(Batch_Mesh& mesh, Search_Options& options) {
+    vector<vector<double>> vertices;
+    vector<vector<int>> faces;
+    set<vector<int>> edges;
+    vector<vector<int>> double_edges;
+    if (!ply_to_embedding(mesh.file_name, vertices, faces, true)) {
+        return false;
+    } //endif
+    makecc(faces, edges, double_edges);
+    create_adjL(vertices, faces, edges, double_edges, mesh.adjL);
+    mesh.eg = CC_Embedded_Graph(mesh.adjL);
+    vector<int> v_order = mesh.eg.getVertexOrdering();
+
+    mesh.instances = vector<Covering_Instance>(2);
+    mesh.crossing = vector<bool>(2);
+    for (int color = 0; color < 2; ++color) {
+        kernelize(mesh.eg, color, v_order, mesh.instances[color]);
+        string ordering;
+        vector<int> empty;
+        if (options.engine == "bb") {
+            mesh.estimate += order_covering_tree(mesh.instances[color], ESTIMATE_PROBES, ordering);
+        }
+        else {
+            mesh.estimate += estimate_search_size(mesh.instances[color], -1, empty, ESTIMATE_PROBES, 0);
+        } //endif
+        mesh.crossing[color] = forced_crossing_staples(mesh.eg, mesh.adjL, color);
+    } //endfor
+    mesh.ready = true;
+    return true;
+}
+
+/*
+ * Writes the results of a batch to batch_summary_<manifest name>.txt and console, one line per mesh (tab
+ * separated): shape name, PLY file, status (solved if an A-trail without crossing staples was routed, unsolved
+ * if the search ended without one, timeout or unreadable), A-trail file of each color ("-" if none), search
+ * nodes and seconds of search
+ *
+ * @param manifest Manifest file
+ * @param meshes Meshes of the batch, searched
+ */
+void write_batch_summary(string manifest, deque<Batch_Mesh>& meshes) {
+    ostringstream summary;
+    summary << "shape\tfile\tstatus\tblue\tred\tnodes\tseconds" << endl;
+    int solved = 0;
+    for (auto& mesh : meshes) {
+        string files[2] = {"-", "-"};
+        bool crossing_free = false;
+        for (int color = 0; color < 2 && mesh.ready; ++color) {
+            if (mesh.trails->isRouted(color)) {
+                files[color] = mesh.trails->getTrailFile(color);
+                crossing_free = crossing_free || files[color].find("_no_crossing_staples") != string::npos;
+            } //endif
+        } //endfor
+        string status = !mesh.ready ? "unreadable" : crossing_free ? "solved" : mesh.timed_out ? "timeout" : "unsolved";
+        solved += crossing_free;
+        double seconds = mesh.started ? chrono::duration<double>(mesh.end - mesh.start).count() : 0;
+        summary << mesh.shape << "\t" << mesh.file_name << "\t" << status << "\t" << files[0] << "\t" << files[1] << "\t"
+                << mesh.nodes << "\t" << seconds << endl;
+    } //endfor
+
+    string o = "batch_summary_" + filesystem::path(manifest).stem().string() + ".txt";
+    ofstream myFile(o);
+    myFile << summary.str();
+    myFile.close();
+    cout << summary.str();
+    cout << solved << " of " << meshes.size() << " meshes solved, summary written to " << o << "." << endl;
+}
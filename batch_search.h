@@ -0,0 +1,43 @@
+#ifndef RATS_BATCH_SEARCH_H
+#define RATS_BATCH_SEARCH_H
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+
+using namespace std;
+
+const int TIMEOUT_POLL_MS = 100; // Milliseconds between checks of the search time of each mesh of a batch
+
+/*
+ * Mesh of a batch: its reduced covering tree searches, and the state of their search on the shared threads
+ */
+struct Batch_Mesh {
+    string file_name;
+    string shape;
+    double timeout = 0;                     // Seconds of search before the mesh is given up (0 for none)
+    bool ready = false;                     // Whether the mesh was read and its searches reduced
+    map<int, vector<int>> adjL;
+    CC_Embedded_Graph eg;
+    vector<Covering_Instance> instances;
+    vector<bool> crossing;                  // Whether every A-trail of each color has crossing staples
+    long double estimate = 0;               // Estimated search nodes of both colors
+    unique_ptr<Search_Pool> pool;           // Open subtrees, taken by the shared threads
+    unique_ptr<Trail_Pipeline> trails;
+    atomic<int> running = 0;                // Threads searching subtrees of the mesh
+    atomic<unsigned long long int> nodes = 0;
+    bool started = false;                   // Whether a subtree was taken (guarded by the batch)
+    atomic<bool> timed_out = false;
+    chrono::steady_clock::time_point start; // First subtree taken
+    chrono::steady_clock::time_point end;   // Last subtree searched
+};
+
+int read_manifest(string manifest, double timeout, deque<Batch_Mesh>& meshes);
+bool prepare_mesh(Batch_Mesh& mesh, Search_Options& options);
+void write_batch_summary(string manifest, deque<Batch_Mesh>& meshes);
+
+#endif //RATS_BATCH_SEARCH_H
@@ -5,8 +5,19 @@
 #include <chrono>
 #include <fstream>
 #include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "td_covering_tree.h"
+#include "growth_covering_tree.h"
+#include "lds_covering_tree.h"
+#include "beam_covering_tree.h"
+#include "comp_covering_tree.h"
+#include "estimate_covering_tree.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
 
 const int INTERVAL = 1000000000;
+const int POOL_INTERVAL = 1024; // Search nodes between checks of the work pool
 
 /*
  * Depth-first search on graph to check for cycles
@@ -135,80 +146,440 @@ bool full_tree_test(CC_Embedded_Graph &eg, vector<int>& ver_stack, int face_colo
 }
 
 /*
- * Branch-bound algorithm to decide which vertices make up a covering tree
+ * Makes the starting point of a search below a decision on a branching vertex, as bb_covering_tree()
  *
- * @param eg Embedded graph
- * @param v Current vertex ordering index to consider
- * @param choice "Yes" or "No" choice on whether to include vertex
- * @param ver_stack Covering tree vertices
- * @param face_color Face color to consider
- * @param v_order BFS vertex ordering
- * @return bool Facilitates  branch-bound decision-making.
+ * @param instance Reduced covering tree search instance
+ * @param v Current branching vertex to consider (-1 to search from the beginning)
+ * @param choice "Yes" (1) or "No" (0) choice on whether to include vertex, or -1 if ver_stack already decides v
+ * @param ver_stack Covering tree vertices decided up to v (including v if choice is 0)
+ * @return Search_Task Open subtree below the decision, with automorphisms preserving the decisions up to v
  */
-bool bb_covering_tree(CC_Embedded_Graph &eg, int v, int choice, vector<int>& ver_stack, int face_color, vector<int>& v_order, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string shape, bool useCheckPoints) {
-    // Time
-    ++iterationCount;
-    if (iterationCount % INTERVAL == 0) {
-        cout << branchNum << "-" << iterationCount << ": ";
-        auto end = chrono::high_resolution_clock::now();
-        auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
-        cout << time.count() << "ms" << endl;
-        start = chrono::high_resolution_clock::now();
-
-        // Save Progress to file
-    #pragma omp critical
-        {
-            if (useCheckPoints) {
-                string o;
-                if (face_color) {
-                    o = "covering_tree_" + shape + "_red_branch_" + to_string(branchNum) + "_checkpoint.txt";
-                } else {
-                    o = "covering_tree_" + shape + "_blue_branch_" + to_string(branchNum) + "_checkpoint.txt";
-                }
-                ofstream myFile(o);
-                for (auto i: ver_stack) {
-                    myFile << i << " ";
-                }
-                myFile << "| ";
-                myFile << v << " " << choice << " " << face_color << " " << branchNum << endl;
-                myFile.close();
-            }
-        }
+Search_Task search_task(Covering_Instance& instance, int v, int choice, vector<int>& ver_stack) {
+    int vertex_count = instance.vertices.size();
+    Search_Task task;
+    task.color = instance.face_color;
+    task.v = v;
+    task.choice = choice == 1 ? 1 : -1;
+    task.ver_stack = ver_stack;
+    if (v != -1 && choice == 0 && !task.ver_stack.empty() && task.ver_stack.back() == v) {
+        task.ver_stack.pop_back(); // "No" after "Yes" leaves v off the stack
+    } //endif
 
-    }
+    // Automorphisms preserving the decisions on branching vertices up to v
+    vector<int> in_stack(vertex_count, 0);
+    for (auto i : task.ver_stack) in_stack[i] = 1;
+    if (v != -1 && task.choice == 1) in_stack[v] = 1;
+    for (int g = 0; g < instance.automorphisms.size(); ++g) {
+        bool preserves = true;
+        for (int i = 0; i <= v && preserves; ++i) {
+            preserves = instance.automorphisms[g][i] <= v && in_stack[instance.automorphisms[g][i]] == in_stack[i];
+        } //endfor
+        if (preserves) task.stabilizer.push_back(g);
+    } //endfor
+    return task;
+}
 
-    // Push or pop vertex onto stack
-    if (v != -1) {
-        if (choice == 1) {
-            ver_stack.push_back(v);
-        }
-        else if (choice == 0) {
-            ver_stack.pop_back();
+/*
+ * Constructor: starts the search below a decision on a branching vertex, as bb_covering_tree()
+ *
+ * @param instance Reduced covering tree search instance
+ * @param v Current branching vertex to consider (-1 to search from the beginning)
+ * @param choice "Yes" (1) or "No" (0) choice on whether to include vertex, or -1 if ver_stack already decides v
+ * @param ver_stack Covering tree vertices decided up to v (including v if choice is 0)
+ * @param iterationCount Number of search nodes before the search
+ * @param branchNum Parallel branch number
+ * @param shape Shape name for checkpoint files
+ * @param useCheckPoints Whether or not to produce checkpoint files
+ */
+Covering_Tree_Generator::Covering_Tree_Generator(Covering_Instance& instance, int v, int choice, vector<int>& ver_stack, unsigned long long int iterationCount, int branchNum, string shape, bool useCheckPoints)
+        : Covering_Tree_Generator(instance, search_task(instance, v, choice, ver_stack), iterationCount, branchNum, shape, useCheckPoints) {
+}
+
+/*
+ * Constructor: searches an open subtree, such as one split off another search by split()
+ *
+ * @param instance Reduced covering tree search instance
+ * @param task Open subtree
+ * @param iterationCount Number of search nodes before the search
+ * @param branchNum Parallel branch number
+ * @param shape Shape name for checkpoint files
+ * @param useCheckPoints Whether or not to produce checkpoint files
+ */
+Covering_Tree_Generator::Covering_Tree_Generator(Covering_Instance& instance, const Search_Task& task, unsigned long long int iterationCount, int branchNum, string shape, bool useCheckPoints)
+        : instance(&instance), stack(task.ver_stack), refuted(task.refuted), branchNum(branchNum), shape(shape), useCheckPoints(useCheckPoints) {
+    int vertex_count = instance.vertices.size();
+    int v = task.v;
+    if (instance.infeasible) {
+        return;
+    } //endif
+
+    // Colored faces joined by current vertex stack
+    forest = Face_Forest(instance.face_count, instance.covered_faces);
+    for (auto i : stack) {
+        if (!forest.canAdd(instance.vertex_faces[i])) {
+            return;
         } //endif
+        forest.add(instance.vertex_faces[i]);
+    } //endfor
+    if (v != -1 && task.choice == 1 && !forest.canAdd(instance.vertex_faces[v])) {
+        return;
     } //endif
 
-    vector<vector<int>> covering_tree;
-    bool covers_all_colored_faces = full_tree_test(eg, ver_stack, face_color, covering_tree, v_order);
-    bool has_cycle = test_for_cycle(covering_tree);
+    // Vertices excluded by current vertex stack or by symmetry above the subtree
+    forbidden = vector<int>(vertex_count, 0);
+    for (auto i : stack) {
+        for (auto u : instance.conflicts[i]) ++forbidden[u];
+    } //endfor
+    for (auto u : refuted) ++forbidden[u];
+    base = stack.size();
 
-    // Checks if covering tree is found
-    if (!has_cycle && covers_all_colored_faces) {
-        return true;
-    }
-    else if (has_cycle || (eg.getVertexCount() - 1) <= v) {
+    stabilizers.resize(vertex_count + 2);
+    orbits.resize(vertex_count + 2);
+    stabilizers[0] = task.stabilizer;
+
+    // Estimated search size, for the time left shown with progress
+    vector<int> decided = stack;
+    if (v != -1 && task.choice == 1) decided.push_back(v);
+    expectedCount = iterationCount + estimate_search_size(instance, v, decided, ESTIMATE_PROBES, branchNum);
+
+    frames.reserve(vertex_count + 1);
+    frames.push_back({v, task.choice, 0, 0});
+}
+
+/*
+ * Removes the innermost decision, taking its vertex back off the stack if it was pushed
+ */
+void Covering_Tree_Generator::pop_frame() {
+    if (frames.back().choice == 1) {
+        int v = stack.back();
+        stack.pop_back();
+        forest.undo();
+        for (auto u : instance->conflicts[v]) --forbidden[u];
+    } //endif
+    frames.pop_back();
+}
+
+/*
+ * Splits off the largest open subtree still to be searched, the "No" to the next vertex of the shallowest
+ * decision whose "Yes" is being searched, for another thread to search
+ *
+ * @param task Open subtree split off
+ * @return bool Whether or not there was a subtree to split off
+ */
+bool Covering_Tree_Generator::split(Search_Task& task) {
+    int depth = 0;
+    int pushed = 0;
+    for (; depth + 1 < frames.size(); ++depth) {
+        if (frames[depth].choice == 1) ++pushed;
+        if (frames[depth].stage == 1) break;
+    } //endfor
+    if (depth + 1 >= frames.size()) {
         return false;
+    } //endif
+    Frame& frame = frames[depth];
+    int next_v = frame.v + 1;
+
+    task.color = instance->face_color;
+    task.v = next_v;
+    task.choice = -1;
+    task.ver_stack.assign(stack.begin(), stack.begin() + base + pushed);
+    task.stabilizer = stabilizers[frame.level];
+
+    // Vertices refuted by symmetry above the subtree, and the orbit of next vertex as stage 1 would forbid it
+    task.refuted = refuted;
+    for (int i = 0; i < depth; ++i) {
+        if (frames[i].stage == 2) task.refuted.insert(task.refuted.end(), orbits[i].begin(), orbits[i].end());
+    } //endfor
+    for (auto g : task.stabilizer) {
+        if (instance->automorphisms[g][next_v] != next_v) task.refuted.push_back(instance->automorphisms[g][next_v]);
+    } //endfor
+    sort(task.refuted.begin(), task.refuted.end());
+    task.refuted.erase(unique(task.refuted.begin(), task.refuted.end()), task.refuted.end());
+
+    frame.stage = 3; // "No" to next vertex is no longer searched here
+    return true;
+}
+
+/*
+ * Hands the rest of the search back to the pool, for any thread to resume: every open subtree split off as by
+ * split(), then the subtree of the decision being entered (the search is over for this thread)
+ */
+void Covering_Tree_Generator::suspend() {
+    Search_Task task;
+    while (split(task)) {
+        pool->push(task);
+    } //endwhile
+
+    // Decision being entered, everything else on the path being done once its subtree is
+    Frame& frame = frames.back();
+    task.color = instance->face_color;
+    task.v = frame.v;
+    task.choice = frame.choice == 1 ? 1 : -1;
+    task.ver_stack = stack;
+    task.stabilizer = stabilizers[frame.level];
+    task.refuted = refuted;
+    for (int i = 0; i + 1 < frames.size(); ++i) {
+        if (frames[i].stage == 2) task.refuted.insert(task.refuted.end(), orbits[i].begin(), orbits[i].end());
+    } //endfor
+    sort(task.refuted.begin(), task.refuted.end());
+    task.refuted.erase(unique(task.refuted.begin(), task.refuted.end()), task.refuted.end());
+    pool->push(task);
+    frames.clear();
+}
+
+/*
+ * Writes progress to console and, if wanted, a checkpoint (see checkpoint())
+ *
+ * @param frame Decision being entered
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ */
+void Covering_Tree_Generator::progress(Frame& frame, unsigned long long int iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start) {
+    int face_color = instance->face_color;
+    auto end = chrono::high_resolution_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
+    {
+        lock_guard<mutex> guard(console_lock);
+        cout << branchNum << "-" << iterationCount << ": ";
+        cout << time.count() << "ms (" << prunedCount << " decisions pruned as closing a cycle, ";
+        if (expectedCount > iterationCount) {
+            cout << "at most about " << (double)((expectedCount - iterationCount) / INTERVAL * time.count() / 1000) << "s left)" << endl;
+        }
+        else {
+            cout << "estimated size exceeded)" << endl;
+        } //endif
+    }
+    start = chrono::high_resolution_clock::now();
+    if (useCheckPoints) {
+        checkpoint(frame);
+    } //endif
+}
+
+/*
+ * Saves the open subtrees from which the search resumes: the current decision and each open subtree it
+ * returns to afterwards, reported to the pool if it keeps checkpoints and written to a checkpoint file of
+ * the branch otherwise
+ *
+ * @param frame Decision being entered
+ */
+void Covering_Tree_Generator::checkpoint(Frame& frame) {
+    int face_color = instance->face_color;
+
+    // Open subtrees of this search: the current decision, then the "No" to the next vertex of each decision
+    // whose "Yes" is being searched, still to be searched after it
+    vector<Search_Task> frontier;
+    Search_Task task;
+    task.color = face_color;
+    task.v = frame.v;
+    task.choice = frame.choice;
+    task.ver_stack = stack;
+    if (frame.choice == 0) {
+        task.ver_stack.push_back(frame.v); // Stack of the "Yes" being undone
+    } //endif
+    frontier.push_back(task);
+    int pushed = 0;
+    for (int i = 0; i + 1 < frames.size(); ++i) {
+        if (frames[i].choice == 1) ++pushed;
+        if (frames[i].stage != 1) continue;
+        task.v = frames[i].v + 1;
+        task.choice = -1;
+        task.ver_stack.assign(stack.begin(), stack.begin() + base + pushed);
+        frontier.push_back(task);
+    } //endfor
+
+    // Save Progress to the checkpoint file of the pool, or else to a file of this branch
+    if (pool != nullptr && pool->keepsCheckpoints()) {
+        pool->report(branchNum, frontier);
     }
     else {
+        lock_guard<mutex> guard(console_lock);
+        string o;
+        if (face_color) {
+            o = "covering_tree_" + shape + "_red_branch_" + to_string(branchNum) + "_checkpoint.txt";
+        } else {
+            o = "covering_tree_" + shape + "_blue_branch_" + to_string(branchNum) + "_checkpoint.txt";
+        }
+        ofstream myFile(o);
+        for (auto& open : frontier) {
+            for (auto i : open.ver_stack) {
+                myFile << i << " ";
+            }
+            myFile << "| ";
+            myFile << open.v << " " << open.choice << " " << face_color << " " << branchNum << endl;
+        }
+        myFile.close();
+    } //endif
+}
+
+/*
+ * Continues the search up to the next covering tree
+ *
+ * @param ver_stack Covering tree vertices (branching vertices of instance) of the covering tree found
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @return bool Whether or not another covering tree was found (false once the search is exhausted)
+ */
+bool Covering_Tree_Generator::next(vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start) {
+    int vertex_count = instance->vertices.size();
+    while (!frames.empty()) {
+        Frame& frame = frames.back();
+        int v = frame.v;
         int next_v = v + 1;
-        bool has_covering_tree = bb_covering_tree(eg, next_v, 1, ver_stack, face_color, v_order, iterationCount, start, branchNum, shape, useCheckPoints); // "Yes" to next vertex
-        if (!has_covering_tree) {
-            bb_covering_tree(eg, next_v, 0, ver_stack, face_color, v_order, iterationCount, start, branchNum, shape, useCheckPoints); // "No" to next vertex
+        if (frame.stage == 0) {
+            // Time
+            ++iterationCount;
+            if (iterationCount % INTERVAL == 0) {
+                progress(frame, iterationCount, start);
+            } //endif
+
+            // Gives work to idle threads, stops once the color is done
+            if (pool != nullptr && iterationCount % POOL_INTERVAL == 0) {
+                pool->count(POOL_INTERVAL);
+                if (pool->isFinished(instance->face_color)) {
+                    frames.clear();
+                    return false;
+                } //endif
+                if (pool->isHungry()) {
+                    Search_Task task;
+                    if (split(task)) pool->push(task);
+                } //endif
+                if (useCheckPoints && pool->isCheckpointDue()) {
+                    checkpoint(frame);
+                } //endif
+                if (pool->release()) {
+                    suspend();
+                    return false;
+                } //endif
+            } //endif
+
+            // Push vertex onto stack
+            if (frame.choice == 1) {
+                stack.push_back(v);
+                forest.add(instance->vertex_faces[v]);
+                for (auto u : instance->conflicts[v]) ++forbidden[u];
+            } //endif
+
+            // Checks if covering tree is found (vertex stack never closes a cycle)
+            if (forest.isTree()) {
+                frame.stage = 3;
+                ver_stack = stack;
+                return true;
+            }
+            else if ((vertex_count - 1) <= v) {
+                pop_frame();
+            }
+            else if (forbidden[next_v]) { // "Yes" to next vertex always closes a 4-cycle or was refuted by symmetry
+                frame.stage = 3;
+                frames.push_back({next_v, -1, 0, frame.level});
+            }
+            else if (!forest.canAdd(instance->vertex_faces[next_v])) { // "Yes" to next vertex closes a cycle
+                ++prunedCount;
+                frame.stage = 3;
+                frames.push_back({next_v, -1, 0, frame.level});
+            }
+            else {
+                // Automorphisms fixing next vertex
+                vector<int>& stabilizer = stabilizers[frame.level];
+                vector<int>& next_stabilizer = stabilizers[frame.level + 1];
+                next_stabilizer.clear();
+                for (auto g : stabilizer) {
+                    if (instance->automorphisms[g][next_v] == next_v) next_stabilizer.push_back(g);
+                } //endfor
+                frame.stage = 1;
+                frames.push_back({next_v, 1, 0, next_stabilizer.size() < stabilizer.size() ? frame.level + 1 : frame.level}); // "Yes" to next vertex
+            } //endif
+        }
+        else if (frame.stage == 1) {
+            // "Yes" was searched for next vertex, so every vertex in its orbit under the stabilizer is too
+            vector<int>& orbit = orbits[frames.size() - 1];
+            orbit.clear();
+            for (auto g : stabilizers[frame.level]) {
+                if (instance->automorphisms[g][next_v] != next_v) orbit.push_back(instance->automorphisms[g][next_v]);
+            } //endfor
+            sort(orbit.begin(), orbit.end());
+            orbit.erase(unique(orbit.begin(), orbit.end()), orbit.end());
+            for (auto u : orbit) ++forbidden[u];
+            frame.stage = 2;
+            frames.push_back({next_v, 0, 0, frame.level}); // "No" to next vertex
         }
         else {
-            return true;
+            if (frame.stage == 2) {
+                for (auto u : orbits[frames.size() - 1]) --forbidden[u];
+            } //endif
+            pop_frame();
+        } //endif
+    } //endwhile
+    return false;
+}
+
+/*
+ * Tests whether covering tree vertices of a reduced instance close a cycle or cover all colored faces
+ *
+ * @param instance Reduced covering tree search instance
+ * @param ver_stack Current selection of covering tree vertices
+ * @param has_cycle Whether or not the covering tree vertices close a cycle
+ * @return Whether or not the covering tree vertices form a covering tree
+ */
+bool instance_tree_test(Covering_Instance& instance, vector<int>& ver_stack, bool& has_cycle) {
+    Face_Forest forest(instance.face_count, instance.covered_faces);
+    has_cycle = instance.infeasible;
+    for (auto i : ver_stack) {
+        if (has_cycle || !forest.canAdd(instance.vertex_faces[i])) {
+            has_cycle = true;
+            return false;
         } //endif
+        forest.add(instance.vertex_faces[i]);
+    } //endfor
+    return forest.isTree();
+}
+
+/*
+ * Branch-bound algorithm to decide which vertices make up a covering tree
+ *
+ * @param instance Reduced covering tree search instance
+ * @param v Current branching vertex to consider
+ * @param choice "Yes" or "No" choice on whether to include vertex
+ * @param ver_stack Covering tree vertices (branching vertices of instance)
+ * @param prunedCount Number of "Yes" decisions pruned as closing a cycle, added to
+ * @return bool Facilitates  branch-bound decision-making.
+ */
+bool bb_covering_tree(Covering_Instance& instance, int v, int choice, vector<int>& ver_stack, unsigned long long int& iterationCount, unsigned long long int& prunedCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string shape, bool useCheckPoints) {
+    if (instance.infeasible) {
+        return false;
     } //endif
 
-    return false;
+    // Fresh searches of low treewidth instances are decided by dynamic programming instead
+    if (v == -1 && ver_stack.empty() && td_width(instance, TD_MAX_WIDTH) <= TD_MAX_WIDTH) {
+        return td_covering_tree(instance, ver_stack);
+    } //endif
+
+    Covering_Tree_Generator trees(instance, v, choice, ver_stack, iterationCount, branchNum, shape, useCheckPoints);
+    bool has_covering_tree = trees.next(ver_stack, iterationCount, start);
+    prunedCount += trees.getPrunedCount();
+    return has_covering_tree;
 }
 
+/*
+ * Searches for a covering tree from the beginning with the chosen engine
+ *
+ * @param instance Reduced covering tree search instance
+ * @param options Search engine ("bb" branch-bound, "growth" connected growth, "lds" limited discrepancy, "beam" beam search, "components" component decomposition) and its settings
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param prunedCount Number of "Yes" decisions pruned as closing a cycle, added to
+ * @return bool Whether or not a covering tree was found
+ */
+bool search_covering_tree(Covering_Instance& instance, Search_Options& options, vector<int>& ver_stack, unsigned long long int& iterationCount, unsigned long long int& prunedCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string shape, bool useCheckPoints) {
+    if (options.engine == "growth") {
+        return growth_covering_tree(instance, ver_stack, iterationCount, start, branchNum);
+    }
+    else if (options.engine == "lds") {
+        return lds_covering_tree(instance, ver_stack, iterationCount, start, branchNum);
+    }
+    else if (options.engine == "beam") {
+        return beam_covering_tree(instance, options.beam_width, ver_stack, iterationCount, start, branchNum);
+    }
+    else if (options.engine == "components") {
+        return comp_covering_tree(instance, ver_stack, iterationCount, start, branchNum);
+    } //endif
+    return bb_covering_tree(instance, -1, 1, ver_stack, iterationCount, prunedCount, start, branchNum, shape, useCheckPoints);
+}
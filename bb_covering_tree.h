@@ -3,10 +3,82 @@
 
 #include "chrono"
 
+/*
+ * Options of covering tree search engines given on the command line
+ */
+struct Search_Options {
+    string engine = "bb";   // Search engine (bb, growth, lds, beam or components)
+    int beam_width = 64;    // Partial vertex stacks kept at each depth by beam search
+    int solutions = 1;      // A-trails without crossing staples wanted per face color before its search stops
+    bool stop_first = false; // Whether the first A-trail without crossing staples (of either color) stops all searches
+    bool pin_threads = false; // Whether parallel branches are pinned to cores, each with its own copy of the search instances
+};
+
+/*
+ * Open subtree of a branch-bound search: decisions on branching vertices up to v are fixed
+ */
+struct Search_Task {
+    int color = 0;                  // Face color of the instance searched
+    int v = -1;                     // Last branching vertex decided (-1 if none)
+    int choice = -1;                // 1 if v is still to be pushed onto ver_stack, -1 if ver_stack already decides v
+    vector<int> ver_stack;          // Covering tree vertices decided up to v
+    vector<int> stabilizer;         // Automorphisms the subtree is searched under
+    vector<int> refuted;            // Vertices excluded by symmetry above the subtree
+};
+
+class Search_Pool;
+
+/*
+ * Class to represent a branch-bound search paused at a covering tree. Every call to next() continues the
+ * depth-first search from where the last one stopped, so each covering tree (up to symmetry) is found once.
+ */
+class Covering_Tree_Generator {
+private:
+    // Decision on a branching vertex, with the stage reached below it
+    struct Frame {
+        int v;
+        int choice;                 // 1 ("Yes"), 0 ("No" after "Yes") or -1 ("No" only)
+        int stage;                  // 0 (entering), 1 ("Yes" to next vertex searched), 2 ("No" to next vertex searched) or 3 (done)
+        int level;                  // Index of stabilizer, one more after each "Yes" with a smaller stabilizer
+    };
+
+    Covering_Instance* instance;
+    Face_Forest forest;
+    vector<int> forbidden;
+    vector<int> stack;
+    vector<Frame> frames;
+    vector<vector<int>> stabilizers;    // Automorphisms preserving decisions, by level (storage reused)
+    vector<vector<int>> orbits;         // Vertices forbidden while "No" to next vertex is searched, by depth (storage reused)
+    vector<int> refuted;                // Vertices excluded by symmetry above the search
+    int base = 0;                       // Vertices on the stack before the search
+    Search_Pool* pool = nullptr;        // Work pool shared with other threads, if any
+    unsigned long long int prunedCount = 0;
+    long double expectedCount = 0;
+    int branchNum;
+    string shape;
+    bool useCheckPoints;
+
+    void pop_frame();
+    void suspend();
+    void progress(Frame& frame, unsigned long long int iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start);
+    void checkpoint(Frame& frame);
+
+public:
+    Covering_Tree_Generator(Covering_Instance& instance, int v, int choice, vector<int>& ver_stack, unsigned long long int iterationCount, int branchNum, string shape, bool useCheckPoints);
+    Covering_Tree_Generator(Covering_Instance& instance, const Search_Task& task, unsigned long long int iterationCount, int branchNum, string shape, bool useCheckPoints);
+    bool split(Search_Task& task);
+    void share(Search_Pool* pool) { this->pool = pool; }
+    bool next(vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start);
+    unsigned long long int getPrunedCount() const { return prunedCount; }
+};
+
+Search_Task search_task(Covering_Instance& instance, int v, int choice, vector<int>& ver_stack);
 bool dfs_cycle(int v, vector<bool>& visited, int parent, vector<vector<int>>& covering_tree);
 bool test_for_cycle(vector<vector<int>>& covering_tree);
 bool is_connected(vector<vector<int>>& covering_tree, int v);
 bool full_tree_test(CC_Embedded_Graph &eg, vector<int>& ver_stack, int face_color, vector<vector<int>>& covering_tree, vector<int>& v_order);
-bool bb_covering_tree(CC_Embedded_Graph &eg, int v, int choice, vector<int>& ver_stack, int face_color, vector<int>& v_order, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string shape, bool useCheckPoints);
+bool instance_tree_test(Covering_Instance& instance, vector<int>& ver_stack, bool& has_cycle);
+bool bb_covering_tree(Covering_Instance& instance, int v, int choice, vector<int>& ver_stack, unsigned long long int& iterationCount, unsigned long long int& prunedCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string shape, bool useCheckPoints);
+bool search_covering_tree(Covering_Instance& instance, Search_Options& options, vector<int>& ver_stack, unsigned long long int& iterationCount, unsigned long long int& prunedCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string shape, bool useCheckPoints);
 
 #endif //RATS_BB_COVERING_TREE_H
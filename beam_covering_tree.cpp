@@ -0,0 +1,183 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <set>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "beam_covering_tree.h"
+
+using namespace std;
+
+const int BEAM_SLACK = 2; // Nodes with an uncovered face down to fewer vertices left than this are ranked last
+
+/*
+ * Partial vertex stack kept in the beam, with its score (lower is better)
+ */
+struct Beam_Node {
+    vector<int> ver_stack;  // Branching vertices chosen, in increasing order
+    int score;              // Uncovered colored faces plus components
+    int slack;              // Fewest vertices left to cover any uncovered face
+};
+
+/*
+ * Whether or not one beam node is more promising than another: nodes with some uncovered face down to its
+ * last vertex rank behind all others, then fewer uncovered faces and components rank first
+ *
+ * @param a First beam node
+ * @param b Second beam node
+ * @return bool Whether or not first node is better
+ */
+bool beam_better(const Beam_Node& a, const Beam_Node& b) {
+    if (min(a.slack, BEAM_SLACK) != min(b.slack, BEAM_SLACK)) return a.slack > b.slack;
+    if (a.score != b.score) return a.score < b.score;
+    if (a.slack != b.slack) return a.slack > b.slack;
+    return a.ver_stack < b.ver_stack;
+}
+
+/*
+ * Expands a beam node by every vertex that does not close a cycle, scoring each child by uncovered colored
+ * faces and components. A child is dropped when some uncovered face has no vertex left that could still be
+ * added without closing a cycle.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param face_vertices Branching vertices of each colored face
+ * @param node Beam node to expand
+ * @param children Scored children to be added to
+ * @param found Covering tree vertices, if a child is a covering tree
+ * @return bool Whether or not a child is a covering tree
+ */
+bool beam_expand(Covering_Instance& instance, vector<vector<int>>& face_vertices, Beam_Node& node, vector<Beam_Node>& children, vector<int>& found) {
+    Face_Forest forest(instance.face_count, instance.covered_faces);
+    vector<bool> chosen(instance.vertices.size(), false);
+    for (auto i : node.ver_stack) {
+        forest.add(instance.vertex_faces[i]);
+        chosen[i] = true;
+    } //endfor
+
+    for (int v = 0; v < instance.vertices.size(); ++v) {
+        if (chosen[v] || !forest.canAdd(instance.vertex_faces[v])) continue;
+        forest.add(instance.vertex_faces[v]);
+        if (forest.isTree()) {
+            found = node.ver_stack;
+            found.push_back(v);
+            sort(found.begin(), found.end());
+            return true;
+        } //endif
+
+        // Remaining-candidate bound: every uncovered face needs a vertex left, and the forest with all vertices
+        // left must still connect every face
+        vector<bool> addable(instance.vertices.size(), false);
+        vector<int> reach(instance.face_count);
+        for (int f = 0; f < instance.face_count; ++f) reach[f] = forest.find(f);
+        auto root = [&reach](int f) {
+            while (reach[f] != f) f = reach[f] = reach[reach[f]];
+            return f;
+        };
+        int reach_components = forest.getComponents();
+        for (int u = 0; u < instance.vertices.size(); ++u) {
+            if (u == v || chosen[u] || !forest.canAdd(instance.vertex_faces[u])) continue;
+            addable[u] = true;
+            for (auto f : instance.vertex_faces[u]) {
+                int a = root(instance.vertex_faces[u][0]);
+                int b = root(f);
+                if (a != b) {
+                    reach[b] = a;
+                    --reach_components;
+                } //endif
+            } //endfor
+        } //endfor
+        int slack = reach_components == 1 ? instance.vertices.size() : 0;
+        for (int f = 0; f < instance.face_count && slack > 0; ++f) {
+            if (forest.isCovered(f)) continue;
+            int left = 0;
+            for (auto u : face_vertices[f]) {
+                if (addable[u]) ++left;
+            } //endfor
+            slack = min(slack, left);
+        } //endfor
+        if (slack > 0) {
+            Beam_Node child;
+            child.ver_stack = node.ver_stack;
+            child.ver_stack.insert(upper_bound(child.ver_stack.begin(), child.ver_stack.end(), v), v);
+            child.score = forest.getUncovered() + forest.getComponents();
+            child.slack = slack;
+            children.push_back(child);
+        } //endif
+        forest.undo();
+    } //endfor
+    return false;
+}
+
+/*
+ * Searches for a covering tree by beam search over partial vertex stacks: every depth adds one vertex to
+ * each kept stack and keeps only the best beam_width children, so time and memory are bounded. The search
+ * is incomplete: failing to find a covering tree does not mean none exists. Children are scored in parallel.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param beam_width Number of partial vertex stacks kept at each depth
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return bool Whether or not a covering tree was found
+ */
+bool beam_covering_tree(Covering_Instance& instance, int beam_width, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    if (instance.infeasible) {
+        return false;
+    } //endif
+
+    vector<vector<int>> face_vertices(instance.face_count);
+    for (int v = 0; v < instance.vertices.size(); ++v) {
+        for (auto f : instance.vertex_faces[v]) face_vertices[f].push_back(v);
+    } //endfor
+
+    Face_Forest empty(instance.face_count, instance.covered_faces);
+    if (empty.isTree()) {
+        ver_stack.clear();
+        return true;
+    } //endif
+    vector<Beam_Node> beam = {{{}, empty.getUncovered() + empty.getComponents(), 0}};
+    bool has_covering_tree = false;
+    int depth = 0;
+    while (!beam.empty() && !has_covering_tree) {
+        vector<Beam_Node> children;
+        atomic<int> next = 0; // Next stack of the beam to expand
+        mutex merge; // Guards children, has_covering_tree and ver_stack
+        parallel_branches(min(engine_threads(), (int)beam.size()), [&](int) {
+            for (int b = next++; b < beam.size(); b = next++) {
+                vector<Beam_Node> local;
+                vector<int> found;
+                bool tree = beam_expand(instance, face_vertices, beam[b], local, found);
+                lock_guard<mutex> guard(merge);
+                if (tree && !has_covering_tree) {
+                    has_covering_tree = true;
+                    ver_stack = found;
+                } //endif
+                children.insert(children.end(), local.begin(), local.end());
+            } //endfor
+        });
+        iterationCount += children.size();
+
+        // Keep best distinct children
+        sort(children.begin(), children.end(), beam_better);
+        children.erase(unique(children.begin(), children.end(), [](const Beam_Node& a, const Beam_Node& b) { return a.ver_stack == b.ver_stack; }), children.end());
+        if (children.size() > beam_width) children.resize(beam_width);
+        beam = children;
+        ++depth;
+    } //endwhile
+
+    auto end = chrono::high_resolution_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
+    {
+        lock_guard<mutex> guard(console_lock);
+        cout << "Branch " << branchNum << ": beam search (width " << beam_width << ") " << (has_covering_tree ? "found a covering tree" : "found no covering tree")
+             << " at depth " << depth << " after " << iterationCount << " nodes in " << time.count() << "ms" << endl;
+    }
+    return has_covering_tree;
+}
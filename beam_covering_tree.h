@@ -0,0 +1,12 @@
+#ifndef RATS_BEAM_COVERING_TREE_H
+#define RATS_BEAM_COVERING_TREE_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+
+using namespace std;
+
+bool beam_covering_tree(Covering_Instance& instance, int beam_width, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum);
+
+#endif //RATS_BEAM_COVERING_TREE_H
@@ -8,6 +8,12 @@
 
 using namespace std;
 
+/*
+ * Constructor: empty graph, assigned once its mesh is read
+ */
+CC_Embedded_Graph::CC_Embedded_Graph() {
+}
+
 /*
  * Constructor
  *
@@ -20,6 +26,10 @@ CC_Embedded_Graph::CC_Embedded_Graph(map<int, vector<int>> &adjL) {
     bfs();
     calcRedFaces(red_faces);
     calcBlueFaces(blue_faces);
+    calcConflicts(red_face_vertices, red_conflicts);
+    calcConflicts(blue_face_vertices, blue_conflicts);
+    calcAutomorphisms(red_face_vertices, red_automorphisms);
+    calcAutomorphisms(blue_face_vertices, blue_automorphisms);
 }
 
 /*
@@ -209,6 +219,167 @@ void CC_Embedded_Graph::calcBlueFaces(vector<Face>& blue_faces) {
     }
 }
 
+/*
+ * Calculate pairwise vertex conflicts for one face color. Two vertices that share two or more faces of
+ * that color always close a 4-cycle in the covering tree, so they can never both be chosen.
+ *
+ * @param face_vertices Vertex-to-face incidence for the face color
+ * @param conflicts Vertex-to-conflicting-vertices list to be made
+ */
+void CC_Embedded_Graph::calcConflicts(vector<vector<int>>& face_vertices, vector<vector<int>>& conflicts) {
+    int color_face_count = 0;
+    for (int i = 0; i < face_vertices.size(); ++i) {
+        for (auto f : face_vertices[i]) {
+            color_face_count = max(color_face_count, f + 1);
+        } //endfor
+    } //endfor
+
+    // Face-to-vertex incidence
+    vector<vector<int>> vertex_faces(color_face_count);
+    for (int i = 0; i < face_vertices.size(); ++i) {
+        for (auto f : face_vertices[i]) {
+            vertex_faces[f].push_back(i);
+        } //endfor
+    } //endfor
+
+    conflicts = vector<vector<int>>(face_vertices.size());
+    vector<int> shared(face_vertices.size(), 0);
+    for (int i = 0; i < face_vertices.size(); ++i) {
+        for (auto f : face_vertices[i]) {
+            for (auto j : vertex_faces[f]) {
+                if (j != i && ++shared[j] == 2) {
+                    conflicts[i].push_back(j);
+                } //endif
+            } //endfor
+        } //endfor
+        for (auto f : face_vertices[i]) {
+            for (auto j : vertex_faces[f]) {
+                shared[j] = 0;
+            } //endfor
+        } //endfor
+    } //endfor
+}
+
+/*
+ * Calculate automorphisms of the embedded graph (rotations and reflections of the rotation system) that
+ * map faces of one color onto faces of the same color. Each automorphism is fixed by the image of a single
+ * dart (vertex and position in its rotation) and its orientation, so every candidate is propagated from one
+ * root dart and kept if it is consistent.
+ *
+ * @param face_vertices Vertex-to-face incidence for the face color
+ * @param automorphisms Vertex permutations to be made (includes identity)
+ */
+void CC_Embedded_Graph::calcAutomorphisms(vector<vector<int>>& face_vertices, vector<vector<int>>& automorphisms) {
+    // Darts as (vertex, position in rotation)
+    vector<int> offset(vertex_count + 1, 0);
+    for (int v = 0; v < vertex_count; ++v) {
+        offset[v + 1] = offset[v] + adjL[v].size();
+    } //endfor
+    int dart_count = offset[vertex_count];
+    vector<int> dart_vertex(dart_count);
+    map<int, vector<int>> edge_darts;
+    for (int v = 0; v < vertex_count; ++v) {
+        for (int i = 0; i < adjL[v].size(); ++i) {
+            dart_vertex[offset[v] + i] = v;
+            edge_darts[adjL[v][i]].push_back(offset[v] + i);
+        } //endfor
+    } //endfor
+    vector<int> opposite(dart_count, -1);
+    bool well_formed = true;
+    for (auto& p : edge_darts) {
+        if (p.second.size() != 2) {
+            well_formed = false;
+            break;
+        } //endif
+        opposite[p.second[0]] = p.second[1];
+        opposite[p.second[1]] = p.second[0];
+    } //endfor
+
+    // Colored faces as sorted vertex sets
+    vector<vector<int>> color_faces;
+    for (int v = 0; v < vertex_count; ++v) {
+        for (auto f : face_vertices[v]) {
+            if (f >= color_faces.size()) color_faces.resize(f + 1);
+            color_faces[f].push_back(v);
+        } //endfor
+    } //endfor
+    set<vector<int>> color_face_set(color_faces.begin(), color_faces.end());
+
+    set<vector<int>> found;
+    int root = 0;
+    int root_degree = adjL[0].size();
+    for (int c = 0; well_formed && c < dart_count; ++c) {
+        if (adjL[dart_vertex[c]].size() != root_degree) continue;
+        for (int s = -1; s <= 1; s += 2) {
+            vector<int> phi(dart_count, -1);
+            vector<bool> used(dart_count, false);
+            queue<int> q;
+            phi[root] = c;
+            used[c] = true;
+            q.push(root);
+            bool valid = true;
+            while (!q.empty() && valid) {
+                int d = q.front();
+                q.pop();
+                int v = dart_vertex[d];
+                int w = dart_vertex[phi[d]];
+                int deg = adjL[v].size();
+                if (adjL[w].size() != deg) {
+                    valid = false;
+                    break;
+                } //endif
+
+                // Next dart in rotation maps to next (or previous, for reflections) dart in rotation
+                int next = offset[v] + (d - offset[v] + 1) % deg;
+                int next_image = offset[w] + (phi[d] - offset[w] + s + deg) % deg;
+
+                // Opposite dart of same edge maps to opposite dart of image
+                for (auto [a, b] : {pair<int, int>(next, next_image), pair<int, int>(opposite[d], opposite[phi[d]])}) {
+                    if (phi[a] == -1) {
+                        if (used[b]) {
+                            valid = false;
+                            break;
+                        } //endif
+                        phi[a] = b;
+                        used[b] = true;
+                        q.push(a);
+                    }
+                    else if (phi[a] != b) {
+                        valid = false;
+                        break;
+                    } //endif
+                } //endfor
+            } //endwhile
+            if (!valid || find(phi.begin(), phi.end(), -1) != phi.end()) continue;
+
+            vector<int> perm(vertex_count);
+            for (int v = 0; v < vertex_count; ++v) {
+                perm[v] = dart_vertex[phi[offset[v]]];
+            } //endfor
+
+            // Faces of color must map onto faces of same color
+            for (auto f : color_faces) {
+                for (auto& v : f) v = perm[v];
+                sort(f.begin(), f.end());
+                if (color_face_set.find(f) == color_face_set.end()) {
+                    valid = false;
+                    break;
+                } //endif
+            } //endfor
+            if (valid) found.insert(perm);
+        } //endfor
+    } //endfor
+
+    // Identity only
+    if (found.empty()) {
+        vector<int> perm(vertex_count);
+        for (int v = 0; v < vertex_count; ++v) perm[v] = v;
+        found.insert(perm);
+    } //endif
+
+    automorphisms = vector<vector<int>>(found.begin(), found.end());
+}
+
 /*
  * Checks whether a Face contains a specified vertex
  *
@@ -98,6 +98,10 @@ private:
     vector<Face> blue_faces;
     vector<vector<int>> red_face_vertices;
     vector<vector<int>> blue_face_vertices;
+    vector<vector<int>> red_conflicts;
+    vector<vector<int>> blue_conflicts;
+    vector<vector<int>> red_automorphisms;
+    vector<vector<int>> blue_automorphisms;
     void create_graph(map<int, vector<int>> adjL);
     void bfs();
     void color_dfs();
@@ -117,6 +121,12 @@ public:
     vector<vector<int>> getBlueFaceV() { return blue_face_vertices; }
     void calcRedFaces(vector<Face>&);
     void calcBlueFaces(vector<Face>&);
+    vector<vector<int>> getRedConflicts() { return red_conflicts; }
+    vector<vector<int>> getBlueConflicts() { return blue_conflicts; }
+    void calcConflicts(vector<vector<int>>& face_vertices, vector<vector<int>>& conflicts);
+    vector<vector<int>> getRedAutomorphisms() { return red_automorphisms; }
+    vector<vector<int>> getBlueAutomorphisms() { return blue_automorphisms; }
+    void calcAutomorphisms(vector<vector<int>>& face_vertices, vector<vector<int>>& automorphisms);
 
 };
 
@@ -0,0 +1,226 @@
+#include <vector>
+#include <string>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+
+#include "cc_embedded_graph.h"
+#include "kernelize.h"
+#include "face_forest.h"
+#include "cnf_covering_tree.h"
+
+using namespace std;
+
+/*
+ * Adds clauses allowing at most one of the given literals to be true
+ *
+ * @param literals Literals
+ * @param clauses Clauses to be added to
+ */
+void cnf_at_most_one(vector<int>& literals, vector<vector<int>>& clauses) {
+    for (int i = 0; i < literals.size(); ++i) {
+        for (int j = 0; j < i; ++j) {
+            clauses.push_back({-literals[i], -literals[j]});
+        } //endfor
+    } //endfor
+}
+
+/*
+ * Encodes the covering tree search as CNF. Variable v + 1 is true if branching vertex v is chosen. The chosen
+ * vertices and the colored faces form a spanning tree exactly if the tree can be rooted at face 0: every other
+ * face picks one chosen vertex as its parent, every chosen vertex picks one of its faces as its parent and
+ * has its other faces as children, and each face has a lower level (binary encoded) than its children.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param var_count Number of variables
+ * @param clauses Clauses as lists of literals
+ */
+void cnf_encode(Covering_Instance& instance, int& var_count, vector<vector<int>>& clauses) {
+    int n = instance.vertices.size();
+    int face_count = instance.face_count;
+    var_count = n;
+    clauses.clear();
+    if (instance.infeasible) {
+        clauses.push_back({}); // Empty clause, unsatisfiable
+        return;
+    } //endif
+
+    // Parent of face f is vertex v (p), parent of vertex v is face f (q)
+    vector<vector<int>> p(n), q(n);
+    vector<vector<int>> face_parents(face_count);
+    for (int v = 0; v < n; ++v) {
+        vector<int> parents;
+        for (auto f : instance.vertex_faces[v]) {
+            p[v].push_back(f == 0 ? 0 : ++var_count);
+            q[v].push_back(++var_count);
+            clauses.push_back({-q[v].back(), v + 1});
+            if (f != 0) {
+                clauses.push_back({-p[v].back(), v + 1});
+                clauses.push_back({-p[v].back(), -q[v].back()});
+                clauses.push_back({-(v + 1), p[v].back(), q[v].back()});
+                face_parents[f].push_back(p[v].back());
+            }
+            else {
+                clauses.push_back({-(v + 1), q[v].back()});
+            } //endif
+        } //endfor
+        vector<int> at_least = q[v];
+        at_least.push_back(-(v + 1));
+        clauses.push_back(at_least);
+        cnf_at_most_one(q[v], clauses);
+    } //endfor
+    for (int f = 1; f < face_count; ++f) {
+        clauses.push_back(face_parents[f]);
+        cnf_at_most_one(face_parents[f], clauses);
+    } //endfor
+    if (face_count == 1 && instance.covered_faces.empty()) {
+        vector<int> any;
+        for (int v = 0; v < n; ++v) any.push_back(v + 1);
+        clauses.push_back(any);
+    } //endif
+
+    // Levels of faces, as bits from most significant
+    int bits = 1;
+    while ((1 << bits) < face_count) ++bits;
+    vector<vector<int>> level(face_count, vector<int>(bits));
+    for (int f = 0; f < face_count; ++f) {
+        for (int i = 0; i < bits; ++i) level[f][i] = ++var_count;
+    } //endfor
+
+    // Face g is the grandparent of face f through some vertex: level of f exceeds level of g
+    map<pair<int, int>, int> below;
+    for (int v = 0; v < n; ++v) {
+        vector<int>& faces = instance.vertex_faces[v];
+        for (int j = 0; j < faces.size(); ++j) {
+            for (int k = 0; k < faces.size(); ++k) {
+                if (j == k || faces[k] == 0) continue;
+                auto it = below.find({faces[j], faces[k]});
+                if (it == below.end()) {
+                    it = below.insert({{faces[j], faces[k]}, ++var_count}).first;
+                } //endif
+                clauses.push_back({-q[v][j], -p[v][k], it->second});
+            } //endfor
+        } //endfor
+    } //endfor
+    for (auto& [pair, d] : below) {
+        vector<int>& a = level[pair.second];
+        vector<int>& b = level[pair.first];
+        int equal = d; // Levels equal on bits so far
+        for (int i = 0; i < bits; ++i) {
+            int next = ++var_count;
+            clauses.push_back({-equal, a[i], -b[i]});
+            clauses.push_back({-equal, a[i], next});
+            clauses.push_back({-equal, -b[i], next});
+            equal = next;
+        } //endfor
+        clauses.push_back({-equal});
+    } //endfor
+}
+
+/*
+ * Writes CNF to a file in DIMACS format, with the covering tree variables noted in comments
+ *
+ * @param instance Reduced covering tree search instance
+ * @param var_count Number of variables
+ * @param clauses Clauses as lists of literals
+ * @param file_name Output file name
+ */
+void write_dimacs(Covering_Instance& instance, int var_count, vector<vector<int>>& clauses, string file_name) {
+    ofstream myFile(file_name);
+    myFile << "c ERDOS covering tree search (" << (instance.face_color ? "red" : "blue") << ")" << endl;
+    myFile << "c variables 1 to " << instance.vertices.size() << " choose covering tree vertices:";
+    for (int v = 0; v < instance.vertices.size(); ++v) {
+        myFile << " " << instance.vertices[v];
+    } //endfor
+    myFile << endl;
+    myFile << "p cnf " << var_count << " " << clauses.size() << endl;
+    for (auto& clause : clauses) {
+        for (auto literal : clause) {
+            myFile << literal << " ";
+        } //endfor
+        myFile << "0" << endl;
+    } //endfor
+    myFile.close();
+}
+
+/*
+ * Reads a solver's output ("s" and "v" lines as in SAT competitions, or a bare model) and keeps the chosen
+ * covering tree vertices
+ *
+ * @param file_name Solver output file name
+ * @param vertex_count Number of branching vertices (the first variables)
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @return bool Whether or not the solver found a model
+ */
+bool read_model(string file_name, int vertex_count, vector<int>& ver_stack) {
+    ifstream myFile(file_name);
+    string line;
+    bool satisfiable = false;
+    bool unsatisfiable = false;
+    ver_stack.clear();
+    while (getline(myFile, line)) {
+        if (line.empty() || line[0] == 'c') continue;
+        if (line.find("UNSAT") != string::npos) {
+            unsatisfiable = true;
+            continue;
+        } //endif
+        if (line.find("SAT") != string::npos) {
+            satisfiable = true;
+            continue;
+        } //endif
+        stringstream ss(line[0] == 'v' ? line.substr(1) : line);
+        int literal;
+        while (ss >> literal) {
+            if (literal > 0 && literal <= vertex_count) {
+                ver_stack.push_back(literal - 1);
+                satisfiable = true;
+            } //endif
+        } //endwhile
+    } //endwhile
+    sort(ver_stack.begin(), ver_stack.end());
+    return satisfiable && !unsatisfiable;
+}
+
+/*
+ * Exports the covering tree search as CNF and, if a solver command is given, runs it on the file and reads the
+ * covering tree back from its output (checked before it is used)
+ *
+ * @param instance Reduced covering tree search instance
+ * @param file_name DIMACS output file name
+ * @param solver_cmd Solver command, given the DIMACS file as last argument (empty to only export)
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @return bool Whether or not a covering tree was found
+ */
+bool cnf_covering_tree(Covering_Instance& instance, string file_name, string solver_cmd, vector<int>& ver_stack) {
+    int var_count;
+    vector<vector<int>> clauses;
+    cnf_encode(instance, var_count, clauses);
+    write_dimacs(instance, var_count, clauses, file_name);
+    cout << "Wrote " << var_count << " variables and " << clauses.size() << " clauses to " << file_name << "." << endl;
+    if (solver_cmd.empty()) {
+        return false;
+    } //endif
+
+    string model_file = file_name + ".out";
+    string command = solver_cmd + " \"" + file_name + "\" > \"" + model_file + "\"";
+    cout << "Running " << command << " ..." << endl;
+    system(command.c_str()); // Solvers exit with 10 (satisfiable) or 20 (unsatisfiable)
+    if (!read_model(model_file, instance.vertices.size(), ver_stack)) {
+        cout << "Solver found no covering tree." << endl;
+        return false;
+    } //endif
+
+    Face_Forest forest(instance.face_count, instance.covered_faces);
+    for (auto v : ver_stack) {
+        if (!forest.canAdd(instance.vertex_faces[v])) break;
+        forest.add(instance.vertex_faces[v]);
+    } //endfor
+    if (!forest.isTree()) {
+        cout << "Solver model is not a covering tree." << endl;
+        return false;
+    } //endif
+    return true;
+}
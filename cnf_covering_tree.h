@@ -0,0 +1,14 @@
+#ifndef RATS_CNF_COVERING_TREE_H
+#define RATS_CNF_COVERING_TREE_H
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+void cnf_encode(Covering_Instance& instance, int& var_count, vector<vector<int>>& clauses);
+void write_dimacs(Covering_Instance& instance, int var_count, vector<vector<int>>& clauses, string file_name);
+bool read_model(string file_name, int vertex_count, vector<int>& ver_stack);
+bool cnf_covering_tree(Covering_Instance& instance, string file_name, string solver_cmd, vector<int>& ver_stack);
+
+#endif //RATS_CNF_COVERING_TREE_H
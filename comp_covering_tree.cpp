@@ -0,0 +1,635 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <map>
+#include <cmath>
+#include <thread>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "comp_covering_tree.h"
+
+using namespace std;
+
+const int COMP_TASK_DEPTH = 4; // Splits deeper than this solve their components serially (with either backend)
+const size_t COMP_CACHE_LIMIT = 1 << 20; // Most component results kept
+
+/*
+ * Residual covering tree problem: super-nodes are groups of colored faces already joined (or single faces),
+ * and each candidate vertex is a hyperedge on the super-nodes of its faces. A covering tree is completed
+ * exactly by a set of candidates forming a spanning tree of this hypergraph.
+ */
+struct Comp_Problem {
+    int node_count;             // Super-nodes, numbered 0..node_count-1
+    vector<int> vertices;       // Candidate branching vertices, in increasing order
+    vector<vector<int>> ends;   // Distinct super-nodes joined by each candidate
+};
+
+/*
+ * Search statistics and cache of component results, keyed by their signature
+ */
+struct Comp_Search {
+    map<vector<int>, pair<bool, vector<int>>> cache;
+    map<vector<int>, long double> counts;   // Spanning tree counts of components (counting only)
+    vector<long double> weights;            // Ways to choose each branching vertex (counting only)
+    mutex lock;                             // Guards cache and counts
+    atomic<int> spare = 0;                  // Threads still free to take components (std::jthread backend)
+    atomic<unsigned long long int> splits = 0;
+    atomic<unsigned long long int> hits = 0;
+};
+
+/*
+ * Signature of a residual problem: its candidates and the super-nodes each joins, numbered in order of
+ * first appearance. Problems with equal signatures have the same solutions.
+ *
+ * @param problem Residual problem
+ * @return vector<int> Signature
+ */
+vector<int> comp_signature(Comp_Problem& problem) {
+    vector<int> key = {problem.node_count};
+    vector<int> relabel(problem.node_count, -1);
+    int next = 0;
+    for (int e = 0; e < problem.vertices.size(); ++e) {
+        key.push_back(problem.vertices[e]);
+        for (auto c : problem.ends[e]) {
+            if (relabel[c] == -1) relabel[c] = next++;
+            key.push_back(relabel[c]);
+        } //endfor
+        key.push_back(-1);
+    } //endfor
+    return key;
+}
+
+/*
+ * Joins super-nodes of a candidate into one, dropping candidates left joining fewer than two super-nodes
+ * (they would close a cycle)
+ *
+ * @param problem Residual problem
+ * @param e Candidate to add
+ * @return Comp_Problem Residual problem with candidate added
+ */
+Comp_Problem comp_contract(Comp_Problem& problem, int e) {
+    vector<int> merged(problem.node_count, -1);
+    for (auto c : problem.ends[e]) merged[c] = 0;
+    vector<int> relabel(problem.node_count);
+    int next = 1;
+    for (int c = 0; c < problem.node_count; ++c) {
+        relabel[c] = merged[c] == 0 ? 0 : next++;
+    } //endfor
+
+    Comp_Problem contracted;
+    contracted.node_count = next;
+    for (int k = 0; k < problem.vertices.size(); ++k) {
+        if (k == e) continue;
+        vector<int> ends;
+        for (auto c : problem.ends[k]) ends.push_back(relabel[c]);
+        sort(ends.begin(), ends.end());
+        if (adjacent_find(ends.begin(), ends.end()) != ends.end()) continue;
+        contracted.vertices.push_back(problem.vertices[k]);
+        contracted.ends.push_back(ends);
+    } //endfor
+    return contracted;
+}
+
+/*
+ * Finds the group of a candidate in the union-find of candidates sharing a block
+ *
+ * @param group Union-find parent of each candidate
+ * @param e Candidate
+ * @return int Representative candidate
+ */
+int comp_group_find(vector<int>& group, int e) {
+    while (group[e] != e) e = group[e] = group[group[e]];
+    return e;
+}
+
+/*
+ * Recursive helper of block (biconnected component) search on the bipartite graph of super-nodes
+ * (0..node_count-1) and candidates (node_count..); candidates of the same block are joined in group
+ *
+ * @param adj Adjacency of bipartite graph
+ * @param n Number of super-nodes
+ * @param u Current node
+ * @param parent Parent of current node in depth-first search
+ * @param timer Discovery counter
+ * @param disc Discovery time of each node (-1 if not visited)
+ * @param low Lowest discovery time reachable from each node's subtree
+ * @param visited Nodes visited and not yet assigned to a block
+ * @param group Union-find parent of each candidate
+ */
+void comp_block_util(vector<vector<int>>& adj, int n, int u, int parent, int& timer, vector<int>& disc, vector<int>& low, vector<int>& visited, vector<int>& group) {
+    disc[u] = low[u] = timer++;
+    visited.push_back(u);
+    for (auto w : adj[u]) {
+        if (disc[w] == -1) {
+            comp_block_util(adj, n, w, u, timer, disc, low, visited, group);
+            low[u] = min(low[u], low[w]);
+            if (low[w] >= disc[u]) {
+                // u and the nodes visited from w down form a block
+                int first = u >= n ? u - n : -1;
+                int x;
+                do {
+                    x = visited.back();
+                    visited.pop_back();
+                    if (x < n) continue;
+                    if (first == -1) first = x - n;
+                    group[comp_group_find(group, x - n)] = comp_group_find(group, first);
+                } while (x != w);
+            } //endif
+        }
+        else if (w != parent) {
+            low[u] = min(low[u], disc[w]);
+        } //endif
+    } //endfor
+}
+
+bool comp_solve(Comp_Problem& problem, vector<int>& chosen, Comp_Search& search, int depth, unsigned long long int& iterationCount);
+
+/*
+ * Runs the jobs of independent parts of a residual problem and waits for them. Near the top of the search
+ * they run as OpenMP tasks, or, with std::jthread workers, on threads of their own while the search has
+ * spare ones; otherwise in turn on the calling thread.
+ *
+ * @param search Cache and statistics
+ * @param count Number of jobs
+ * @param depth Number of splits above the problem
+ * @param job Work of one job, given its number
+ */
+void comp_parallel(Comp_Search& search, int count, int depth, const function<void(int)>& job) {
+#ifdef USE_OPENMP
+    for (int k = 0; k < count; ++k) {
+        #pragma omp task shared(job) if(depth < COMP_TASK_DEPTH)
+        job(k);
+    } //endfor
+    #pragma omp taskwait
+#else
+    vector<jthread> threads;
+    for (int k = 0; k < count; ++k) {
+        bool spawned = false;
+        int spare = search.spare;
+        while (depth < COMP_TASK_DEPTH && k + 1 < count && spare > 0 && !spawned) {
+            spawned = search.spare.compare_exchange_weak(spare, spare - 1);
+        } //endwhile
+        if (spawned) {
+            threads.emplace_back([&search, &job, k]() {
+                job(k);
+                ++search.spare;
+            });
+        }
+        else {
+            job(k);
+        } //endif
+    } //endfor
+#endif
+}
+
+/*
+ * Splits a connected residual problem into independent components: its blocks, joined where a candidate
+ * belongs to several. Components share only super-nodes whose removal disconnects the problem, so spanning
+ * trees of the components together form a spanning tree.
+ *
+ * @param problem Residual problem (connected)
+ * @param components Components to be made
+ */
+void comp_split(Comp_Problem& problem, vector<Comp_Problem>& components) {
+    int n = problem.node_count;
+    int m = problem.vertices.size();
+    vector<vector<int>> adj(n + m);
+    for (int e = 0; e < m; ++e) {
+        for (auto c : problem.ends[e]) {
+            adj[c].push_back(n + e);
+            adj[n + e].push_back(c);
+        } //endfor
+    } //endfor
+    vector<int> disc(n + m, -1);
+    vector<int> low(n + m, 0);
+    vector<int> visited;
+    vector<int> group(m);
+    for (int e = 0; e < m; ++e) group[e] = e;
+    int timer = 0;
+    comp_block_util(adj, n, 0, -1, timer, disc, low, visited, group);
+
+    // Components are blocks joined at shared candidates, numbered in order of first candidate
+    vector<int> number(m, -1);
+    int group_count = 0;
+    for (int e = 0; e < m; ++e) {
+        int r = comp_group_find(group, e);
+        if (number[r] == -1) number[r] = group_count++;
+        group[e] = r;
+    } //endfor
+    for (int e = 0; e < m; ++e) group[e] = number[group[e]];
+
+    components = vector<Comp_Problem>(group_count);
+    vector<vector<int>> relabel(group_count, vector<int>(n, -1));
+    for (auto& component : components) component.node_count = 0;
+    for (int e = 0; e < m; ++e) {
+        Comp_Problem& component = components[group[e]];
+        vector<int> ends;
+        for (auto c : problem.ends[e]) {
+            if (relabel[group[e]][c] == -1) relabel[group[e]][c] = component.node_count++;
+            ends.push_back(relabel[group[e]][c]);
+        } //endfor
+        component.vertices.push_back(problem.vertices[e]);
+        component.ends.push_back(ends);
+    } //endfor
+}
+
+/*
+ * Solves a residual problem: forces candidates that are the only ones at a super-node, splits the problem
+ * into independent components (solved in parallel near the top of the search, and cached), and otherwise
+ * branches on a candidate at the super-node with fewest candidates.
+ *
+ * @param problem Residual problem
+ * @param chosen Candidates chosen to be added to
+ * @param search Cache and statistics
+ * @param depth Number of splits above this problem
+ * @param iterationCount Number of search nodes
+ * @return bool Whether or not problem has a spanning tree
+ */
+bool comp_solve(Comp_Problem& problem, vector<int>& chosen, Comp_Search& search, int depth, unsigned long long int& iterationCount) {
+    atomic_ref<unsigned long long int>(iterationCount)++;
+
+    if (problem.node_count == 1) {
+        return true;
+    } //endif
+
+    // Super-nodes without candidates cannot be joined, ones with a single candidate force it
+    vector<int> degree(problem.node_count, 0);
+    for (auto& ends : problem.ends) {
+        for (auto c : ends) ++degree[c];
+    } //endfor
+    int fewest = -1;
+    for (int c = 0; c < problem.node_count; ++c) {
+        if (degree[c] == 0) return false;
+        if (fewest == -1 || degree[c] < degree[fewest]) fewest = c;
+    } //endfor
+    int next_e = -1;
+    for (int e = 0; e < problem.vertices.size() && next_e == -1; ++e) {
+        if (find(problem.ends[e].begin(), problem.ends[e].end(), fewest) != problem.ends[e].end()) next_e = e;
+    } //endfor
+    if (degree[fewest] == 1) {
+        Comp_Problem contracted = comp_contract(problem, next_e);
+        vector<int> sub;
+        if (!comp_solve(contracted, sub, search, depth, iterationCount)) return false;
+        chosen.push_back(problem.vertices[next_e]);
+        chosen.insert(chosen.end(), sub.begin(), sub.end());
+        return true;
+    } //endif
+
+    // Cached result
+    vector<int> key = comp_signature(problem);
+    bool cached = false;
+    pair<bool, vector<int>> result;
+    {
+        lock_guard<mutex> guard(search.lock);
+        auto it = search.cache.find(key);
+        if (it != search.cache.end()) {
+            cached = true;
+            result = it->second;
+            ++search.hits;
+        } //endif
+    }
+    if (cached) {
+        if (result.first) chosen.insert(chosen.end(), result.second.begin(), result.second.end());
+        return result.first;
+    } //endif
+
+    // Disconnected problems have no spanning tree
+    vector<int> reach(problem.node_count);
+    for (int c = 0; c < problem.node_count; ++c) reach[c] = c;
+    auto root = [&reach](int c) {
+        while (reach[c] != c) c = reach[c] = reach[reach[c]];
+        return c;
+    };
+    int reach_components = problem.node_count;
+    for (auto& ends : problem.ends) {
+        for (auto c : ends) {
+            int a = root(ends[0]);
+            int b = root(c);
+            if (a != b) {
+                reach[b] = a;
+                --reach_components;
+            } //endif
+        } //endfor
+    } //endfor
+    result = {false, {}};
+    if (reach_components == 1) {
+        vector<Comp_Problem> components;
+        comp_split(problem, components);
+        if (components.size() > 1) {
+            // Independent components
+            ++search.splits;
+            vector<vector<int>> sub(components.size());
+            vector<int> solved(components.size(), 0);
+            comp_parallel(search, components.size(), depth, [&](int k) {
+                solved[k] = comp_solve(components[k], sub[k], search, depth + 1, iterationCount);
+            });
+            result.first = find(solved.begin(), solved.end(), 0) == solved.end();
+            for (int k = 0; k < components.size() && result.first; ++k) {
+                result.second.insert(result.second.end(), sub[k].begin(), sub[k].end());
+            } //endfor
+        }
+        else {
+            // "Yes" to candidate at super-node with fewest candidates
+            Comp_Problem contracted = comp_contract(problem, next_e);
+            vector<int> sub;
+            if (comp_solve(contracted, sub, search, depth, iterationCount)) {
+                result.first = true;
+                result.second = {problem.vertices[next_e]};
+                result.second.insert(result.second.end(), sub.begin(), sub.end());
+            }
+            else {
+                // "No" to candidate
+                Comp_Problem reduced = problem;
+                reduced.vertices.erase(reduced.vertices.begin() + next_e);
+                reduced.ends.erase(reduced.ends.begin() + next_e);
+                result.first = comp_solve(reduced, result.second, search, depth, iterationCount);
+            } //endif
+        } //endif
+    } //endif
+
+    {
+        lock_guard<mutex> guard(search.lock);
+        if (search.cache.size() < COMP_CACHE_LIMIT) search.cache[key] = result;
+    }
+    if (result.first) chosen.insert(chosen.end(), result.second.begin(), result.second.end());
+    return result.first;
+}
+
+/*
+ * Searches for a covering tree by dynamic component decomposition: the residual problem left by chosen
+ * vertices is split into independent components wherever a super-node (group of joined colored faces)
+ * separates it, and component results are cached by signature.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return bool Whether or not a covering tree exists
+ */
+bool comp_covering_tree(Covering_Instance& instance, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    int vertex_count = instance.vertices.size();
+    if (instance.infeasible) {
+        return false;
+    } //endif
+    ver_stack.clear();
+    if (instance.face_count <= 1) {
+        if (!instance.covered_faces.empty()) return true;
+        if (vertex_count == 0) return false;
+        ver_stack.push_back(0);
+        return true;
+    } //endif
+
+    Comp_Problem problem;
+    problem.node_count = instance.face_count;
+    for (int v = 0; v < vertex_count; ++v) {
+        if (instance.vertex_faces[v].size() < 2) continue;
+        problem.vertices.push_back(v);
+        problem.ends.push_back(instance.vertex_faces[v]);
+    } //endfor
+
+    Comp_Search search;
+    search.spare = engine_threads() - 1;
+    bool has_covering_tree = false;
+    #pragma omp parallel shared(problem, search, has_covering_tree, ver_stack, iterationCount)
+    {
+        #pragma omp single
+        has_covering_tree = comp_solve(problem, ver_stack, search, 0, iterationCount);
+    }
+    sort(ver_stack.begin(), ver_stack.end()); // Stack in branching order, as from branch-bound search
+
+    auto end = chrono::high_resolution_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
+    {
+        lock_guard<mutex> guard(console_lock);
+        cout << "Branch " << branchNum << ": component search " << (has_covering_tree ? "found a covering tree" : "found no covering tree")
+             << " after " << iterationCount << " nodes, " << search.splits << " splits and " << search.hits << " cached components in " << time.count() << "ms" << endl;
+    }
+    return has_covering_tree;
+}
+
+/*
+ * Counts the spanning trees of a residual problem whose candidates all join two super-nodes (a multigraph),
+ * weighted by the product of candidate weights, as the determinant of its Laplacian with one super-node
+ * removed (matrix-tree theorem). Laplacians are diagonally dominant, so elimination needs no pivoting, and
+ * the count is exact while it has fewer digits than a long double holds.
+ *
+ * @param problem Residual problem with candidates joining two super-nodes each
+ * @param search Weights
+ * @return long double Weighted number of spanning trees
+ */
+long double comp_kirchhoff(Comp_Problem& problem, Comp_Search& search) {
+    int n = problem.node_count - 1;
+    vector<vector<long double>> laplacian(n, vector<long double>(n, 0));
+    for (int e = 0; e < problem.vertices.size(); ++e) {
+        int a = problem.ends[e][0] - 1;
+        int b = problem.ends[e][1] - 1;
+        long double w = search.weights[problem.vertices[e]];
+        if (a >= 0) laplacian[a][a] += w;
+        if (b >= 0) laplacian[b][b] += w;
+        if (a >= 0 && b >= 0) {
+            laplacian[a][b] -= w;
+            laplacian[b][a] -= w;
+        } //endif
+    } //endfor
+
+    long double det = 1;
+    for (int i = 0; i < n; ++i) {
+        if (laplacian[i][i] == 0) return 0;
+        det *= laplacian[i][i];
+        for (int j = i + 1; j < n; ++j) {
+            if (laplacian[j][i] == 0) continue;
+            long double factor = laplacian[j][i] / laplacian[i][i];
+            for (int k = i; k < n; ++k) laplacian[j][k] -= factor * laplacian[i][k];
+        } //endfor
+    } //endfor
+    return roundl(det);
+}
+
+/*
+ * Counts the spanning trees of a residual problem, each weighted by the product of the weights of its
+ * candidates: forced candidates and independent components multiply, and otherwise the trees with and
+ * without the candidate joining most super-nodes are added, down to problems the matrix-tree theorem counts.
+ * Counts of components are cached.
+ *
+ * @param problem Residual problem
+ * @param search Cache, weights and statistics
+ * @param depth Number of splits and branches above this problem
+ * @param iterationCount Number of search nodes
+ * @return long double Weighted number of spanning trees
+ */
+long double comp_count(Comp_Problem& problem, Comp_Search& search, int depth, unsigned long long int& iterationCount) {
+    atomic_ref<unsigned long long int>(iterationCount)++;
+
+    if (problem.node_count == 1) {
+        return 1;
+    } //endif
+
+    // Super-nodes without candidates cannot be joined, ones with a single candidate force it
+    vector<int> degree(problem.node_count, 0);
+    for (auto& ends : problem.ends) {
+        for (auto c : ends) ++degree[c];
+    } //endfor
+    int fewest = -1;
+    for (int c = 0; c < problem.node_count; ++c) {
+        if (degree[c] == 0) return 0;
+        if (fewest == -1 || degree[c] < degree[fewest]) fewest = c;
+    } //endfor
+    int next_e = -1;
+    for (int e = 0; e < problem.vertices.size() && next_e == -1; ++e) {
+        if (find(problem.ends[e].begin(), problem.ends[e].end(), fewest) != problem.ends[e].end()) next_e = e;
+    } //endfor
+    if (degree[fewest] == 1) {
+        Comp_Problem contracted = comp_contract(problem, next_e);
+        return search.weights[problem.vertices[next_e]] * comp_count(contracted, search, depth, iterationCount);
+    } //endif
+
+    // Candidates joining more than two super-nodes are branched on, the rest counted by the matrix-tree theorem
+    int most = next_e;
+    for (int e = 0; e < problem.vertices.size(); ++e) {
+        if (problem.ends[e].size() > problem.ends[most].size()) most = e;
+    } //endfor
+    if (problem.ends[most].size() == 2) {
+        return comp_kirchhoff(problem, search);
+    } //endif
+    next_e = most;
+    long double weight = search.weights[problem.vertices[next_e]];
+
+    // Cached count
+    vector<int> key = comp_signature(problem);
+    bool cached = false;
+    long double count = 0;
+    {
+        lock_guard<mutex> guard(search.lock);
+        auto it = search.counts.find(key);
+        if (it != search.counts.end()) {
+            cached = true;
+            count = it->second;
+            ++search.hits;
+        } //endif
+    }
+    if (cached) {
+        return count;
+    } //endif
+
+    // Disconnected problems have no spanning tree
+    vector<int> reach(problem.node_count);
+    for (int c = 0; c < problem.node_count; ++c) reach[c] = c;
+    auto root = [&reach](int c) {
+        while (reach[c] != c) c = reach[c] = reach[reach[c]];
+        return c;
+    };
+    int reach_components = problem.node_count;
+    for (auto& ends : problem.ends) {
+        for (auto c : ends) {
+            int a = root(ends[0]);
+            int b = root(c);
+            if (a != b) {
+                reach[b] = a;
+                --reach_components;
+            } //endif
+        } //endfor
+    } //endfor
+    if (reach_components == 1) {
+        vector<Comp_Problem> components;
+        comp_split(problem, components);
+        if (components.size() > 1) {
+            // Independent components
+            ++search.splits;
+            vector<long double> sub(components.size());
+            comp_parallel(search, components.size(), depth, [&](int k) {
+                sub[k] = comp_count(components[k], search, depth + 1, iterationCount);
+            });
+            count = 1;
+            for (auto c : sub) count *= c;
+        }
+        else {
+            // Trees with and without candidate joining most super-nodes
+            Comp_Problem contracted = comp_contract(problem, next_e);
+            Comp_Problem reduced = problem;
+            reduced.vertices.erase(reduced.vertices.begin() + next_e);
+            reduced.ends.erase(reduced.ends.begin() + next_e);
+            long double with = 0, without = 0;
+            comp_parallel(search, 2, depth, [&](int k) {
+                if (k == 0) with = weight * comp_count(contracted, search, depth + 1, iterationCount);
+                else without = comp_count(reduced, search, depth + 1, iterationCount);
+            });
+            count = with + without;
+        } //endif
+    } //endif
+
+    {
+        lock_guard<mutex> guard(search.lock);
+        if (search.counts.size() < COMP_CACHE_LIMIT) search.counts[key] = count;
+    }
+    return count;
+}
+
+/*
+ * Counts covering trees without listing them, by the component decomposition of comp_covering_tree().
+ * Every covering tree is counted, whatever the symmetries of the instance.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param original Whether or not to count covering trees of the original vertices (any vertex of the class of
+ * each forced and branching vertex, with or without each vertex with a single colored face) instead of the
+ * branching vertices (covering trees as found)
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return long double Number of covering trees
+ */
+long double count_covering_trees(Covering_Instance& instance, bool original, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    int vertex_count = instance.vertices.size();
+    if (instance.infeasible) {
+        return 0;
+    } //endif
+
+    // Covering trees of the original vertices multiply by the choices reduction left out of the instance
+    long double factor = 1;
+    if (original) {
+        for (auto& members : instance.forced_classes) factor *= members.size();
+        factor *= powl(2, instance.leaves.size());
+    } //endif
+
+    Comp_Search search;
+    for (int v = 0; v < vertex_count; ++v) {
+        search.weights.push_back(original ? instance.classes[v].size() : 1);
+    } //endfor
+    if (instance.face_count <= 1) {
+        if (!instance.covered_faces.empty()) return factor;
+        long double count = 0;
+        for (auto w : search.weights) count += w;
+        return factor * count;
+    } //endif
+
+    Comp_Problem problem;
+    problem.node_count = instance.face_count;
+    for (int v = 0; v < vertex_count; ++v) {
+        if (instance.vertex_faces[v].size() < 2) continue;
+        problem.vertices.push_back(v);
+        problem.ends.push_back(instance.vertex_faces[v]);
+    } //endfor
+
+    search.spare = engine_threads() - 1;
+    long double count = 0;
+    #pragma omp parallel shared(problem, search, count, iterationCount)
+    {
+        #pragma omp single
+        count = comp_count(problem, search, 0, iterationCount);
+    }
+
+    auto end = chrono::high_resolution_clock::now();
+    auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
+    {
+        lock_guard<mutex> guard(console_lock);
+        cout << "Branch " << branchNum << ": counted after " << iterationCount << " nodes, " << search.splits << " splits and "
+             << search.hits << " cached components in " << time.count() << "ms" << endl;
+    }
+    return factor * count;
+}
@@ -0,0 +1,13 @@
+#ifndef RATS_COMP_COVERING_TREE_H
+#define RATS_COMP_COVERING_TREE_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+
+using namespace std;
+
+bool comp_covering_tree(Covering_Instance& instance, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum);
+long double count_covering_trees(Covering_Instance& instance, bool original, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum);
+
+#endif //RATS_COMP_COVERING_TREE_H
@@ -0,0 +1,576 @@
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <memory>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <filesystem>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "trail_pipeline.h"
+#include "distributed_search.h"
+#include "batch_search.h"
+#include "daemon_search.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/socket.h>
+#endif
+
+using namespace std;
+
+/*
+ * Gives the cache key of a mesh: its PLY file (with modification time and size, so an edited file is built
+ * again) or a hash of its inline text, and whether its searches are ordered for the branch-bound search
+ *
+ * @param file_name PLY file (empty if the mesh was sent inline)
+ * @param mesh_text PLY text sent inline
+ * @param engine Covering tree search engine
+ * @return string Key
+ */
+string mesh_key(const string& file_name, const string& mesh_text, const string& engine) {
+    ostringstream key;
+    if (file_name.empty()) {
+        key << "inline " << hex << hash<string>{}(mesh_text) << dec << " " << mesh_text.size();
+    }
+    else {
+        error_code error;
+        filesystem::path path = filesystem::canonical(file_name, error);
+        if (error) path = file_name;
+        key << path.string();
+        auto modified = filesystem::last_write_time(path, error);
+        if (!error) key << " " << modified.time_since_epoch().count() << " " << filesystem::file_size(path, error);
+    } //endif
+    key << (engine == "bb" ? " ordered" : " unordered");
+    return key.str();
+}
+
+/*
+ * Reads a job request: "SEARCH <given_shape_name> <input_PLY_file> [options]", or with "inline:<lines>" in
+ * place of the PLY file when that many lines of PLY text follow the request. Options are those of a single
+ * run (--engine, --beam-width, --solutions, --stop-first) and --timeout=<seconds>.
+ *
+ * @param line Request
+ * @param job Job requested
+ * @param error Why the request is malformed
+ * @return bool Whether or not the request was read
+ */
+bool read_job_line(const string& line, Daemon_Job& job, string& error) {
+    istringstream stream(line);
+    string kind, mesh, option;
+    stream >> kind;
+    if (!(stream >> job.shape >> mesh)) {
+        error = "expected SEARCH <given_shape_name> <input_PLY_file>|inline:<lines> [options]";
+        return false;
+    } //endif
+    if (mesh.rfind("inline:", 0) == 0) {
+        if (!(istringstream(mesh.substr(7)) >> job.mesh_lines) || job.mesh_lines < 1) {
+            error = "inline mesh needs its number of lines, as inline:<lines>";
+            return false;
+        } //endif
+    }
+    else {
+        job.file_name = mesh;
+    } //endif
+
+    while (stream >> option) {
+        istringstream value(option.substr(option.find('=') + 1));
+        if (option.rfind("--engine=", 0) == 0) {
+            job.options.engine = option.substr(9);
+            if (job.options.engine != "bb" && job.options.engine != "growth" && job.options.engine != "lds" && job.options.engine != "beam" && job.options.engine != "components") {
+                error = "unknown engine " + job.options.engine;
+                return false;
+            } //endif
+        }
+        else if (option.rfind("--beam-width=", 0) == 0 && value >> job.options.beam_width) {
+            job.options.beam_width = max(1, job.options.beam_width);
+        }
+        else if (option.rfind("--solutions=", 0) == 0 && value >> job.options.solutions) {
+            job.options.solutions = max(1, job.options.solutions);
+        }
+        else if (option == "--stop-first") {
+            job.options.stop_first = true;
+        }
+        else if (option.rfind("--timeout=", 0) == 0 && value >> job.timeout) {
+            job.timeout = max(0.0, job.timeout);
+        }
+        else {
+            error = "unknown option " + option;
+            return false;
+        } //endif
+    } //endwhile
+    return true;
+}
+
+#ifndef _WIN32
+/*
+ * Built mesh kept by a daemon between jobs
+ */
+struct Cached_Mesh {
+    shared_ptr<Batch_Mesh> mesh;
+    unsigned long long int used = 0;    // Last use (daemon-wide count)
+};
+
+/*
+ * Result of a job kept by a daemon, replayed for the same job
+ */
+struct Cached_Result {
+    vector<string> solutions;           // Face color and A-trail file of each solution
+    string summary;                     // Status, search nodes and seconds
+    unsigned long long int used = 0;    // Last use (daemon-wide count)
+};
+#endif
+
+/*
+ * Daemon serving covering tree searches to clients on a socket, so repeated calls skip process startup and
+ * mesh building. Its threads start once and take open subtrees of every job being searched, from the job
+ * with the smallest estimated search first; a thread finding none asks the jobs being searched to split
+ * subtrees off for it (as in batch mode). Built meshes are kept in memory (keyed by file, modification time
+ * and size, or by inline text) and shared by jobs; results of jobs that ended are kept and replayed when the
+ * same job is requested again.
+ *
+ * A client sends one request per line (any number, on one connection):
+ *   SEARCH <given_shape_name> <input_PLY_file>|inline:<lines> [options]   (see read_job_line())
+ *   CANCEL <job>
+ *   SHUTDOWN  (cancels every job, then the daemon exits)
+ * and gets, for each job:
+ *   ACCEPTED <job> new|cached|result     (mesh to be built, mesh built before, or result of the same job before)
+ *   PROGRESS <job> <nodes> <seconds>     (every PROGRESS_SECONDS while it is searched)
+ *   SOLUTION <job> blue|red <file>       (A-trail without crossing staples, or with forced ones, once written)
+ *   DONE <job> <status> <nodes> <seconds>  (solved, unsolved, timeout, cancelled or unreadable)
+ * or, for a request it cannot serve:
+ *   ERROR <reason>                       (malformed request)
+ *   ERROR unknown job                    (CANCEL of a job not running on the connection)
+ * A-trail files are written in the daemon's working directory, named after the shape name as in batch mode;
+ * jobs searched at once should have different shape names. Closing the connection cancels its jobs.
+ *
+ * @param address Address to listen on ("unix:<path>", or "<host>:<port>" or "<port>" for TCP)
+ * @param branches Number of threads
+ * @param search Searches an open subtree of a job on the pool and pipeline of the job, with the branch number and
+ *               name for A-trail files given (returns the number of search nodes)
+ * @return int Exit status
+ */
+int run_daemon(string address, int branches, const function<unsigned long long int(Batch_Mesh&, Search_Options&, Search_Task&, Search_Pool&, Trail_Pipeline&, int, string)>& search) {
+#ifdef _WIN32
+    cerr << "Daemon mode needs POSIX sockets, which are not available on this system." << endl;
+    return 1;
+#else
+    signal(SIGPIPE, SIG_IGN);
+    int listener = open_socket(address, true);
+    if (listener < 0) {
+        cerr << "Could not listen on " << address << "." << endl;
+        return 1;
+    } //endif
+
+    mutex lock;                             // Guards jobs, caches and the state of jobs shared with threads
+    condition_variable_any submitted;       // Signals jobs submitted (or their meshes built)
+    unsigned long long int events = 0;      // Jobs submitted and meshes built
+    vector<shared_ptr<Daemon_Job>> jobs;    // Jobs submitted, not yet done
+    map<string, Cached_Mesh> meshes;
+    map<string, Cached_Result> results;
+    unsigned long long int uses = 0;
+    auto evict = [](auto& cache, int limit) {
+        while (cache.size() > limit) {
+            cache.erase(min_element(cache.begin(), cache.end(), [](auto& a, auto& b) { return a.second.used < b.second.used; }));
+        } //endwhile
+    };
+
+    // Both colors of a job start as one open subtree each (lock held)
+    auto start_job = [&](Daemon_Job& job) {
+        job.pool = make_unique<Search_Pool>(0, job.options.solutions, job.options.stop_first);
+        for (int color = 0; color < 2; ++color) {
+            vector<int> empty;
+            Search_Task task = search_task(job.mesh->instances[color], -1, 0, empty);
+            job.pool->push(task);
+        } //endfor
+        job.trails = make_unique<Trail_Pipeline>(job.mesh->eg, job.mesh->adjL, job.mesh->instances, *job.pool, 1);
+        job.start = job.progress = chrono::steady_clock::now();
+        ++events;
+    };
+    // Reply to a job cancelled before its end, with the search nodes and seconds so far (lock held)
+    auto cancelled = [](Daemon_Job& job) {
+        unsigned long long int nodes = job.nodes;
+        double seconds = 0;
+        if (job.pool) {
+            nodes = max(nodes, job.pool->getNodeCount());
+            seconds = chrono::duration<double>(chrono::steady_clock::now() - job.start).count();
+        } //endif
+        return "DONE " + to_string(job.id) + " cancelled " + to_string(nodes) + " " + to_string(seconds);
+    };
+    auto cancel = [](Daemon_Job& job) {
+        job.cancelled = true;
+        job.fd = -1;
+        if (job.pool) {
+            job.pool->finish(0);
+            job.pool->finish(1);
+        } //endif
+    };
+
+    // Threads started once, building meshes and searching subtrees of every job
+    vector<jthread> threads;
+    for (int i = 0; i < branches; ++i) {
+        threads.emplace_back([&, i](stop_token stop) {
+            set_engine_threads(1); // Engines searching a whole color stay on their thread
+            while (!stop.stop_requested()) {
+                shared_ptr<Daemon_Job> job;
+                Search_Task task;
+                bool build = false;
+                bool busy = false;
+                {
+                    unique_lock<mutex> guard(lock);
+
+                    // Jobs waiting for their mesh: built before, or built here (once for jobs of the same mesh)
+                    for (auto& waiting : jobs) {
+                        if (waiting->mesh || waiting->building || waiting->unreadable || waiting->cancelled) {
+                            continue;
+                        } //endif
+                        auto cached = meshes.find(waiting->mesh_key);
+                        if (cached != meshes.end()) {
+                            cached->second.used = ++uses;
+                            waiting->mesh = cached->second.mesh;
+                            start_job(*waiting);
+                        }
+                        else if (none_of(jobs.begin(), jobs.end(), [&waiting](auto& other) { return other->building && other->mesh_key == waiting->mesh_key; })) {
+                            waiting->building = true;
+                            job = waiting;
+                            build = true;
+                            break;
+                        } //endif
+                    } //endfor
+
+                    // Otherwise a subtree of the job with the smallest estimated search
+                    if (!job) {
+                        vector<shared_ptr<Daemon_Job>> searching;
+                        for (auto& candidate : jobs) {
+                            if (candidate->pool) searching.push_back(candidate);
+                        } //endfor
+                        stable_sort(searching.begin(), searching.end(), [](auto& a, auto& b) { return a->mesh->estimate < b->mesh->estimate; });
+                        for (auto& candidate : searching) {
+                            if (candidate->pool->tryPop(task)) {
+                                job = candidate;
+                                ++job->running;
+                                break;
+                            } //endif
+                        } //endfor
+                    } //endif
+
+                    // Nothing queued: jobs being searched split subtrees off, or the thread waits for jobs
+                    if (!job) {
+                        for (auto& candidate : jobs) {
+                            if (candidate->running > 0) {
+                                busy = true;
+                                if (!candidate->pool->isHungry()) candidate->pool->want();
+                            } //endif
+                        } //endfor
+                        if (!busy) {
+                            auto seen = events;
+                            submitted.wait_for(guard, stop, chrono::milliseconds(LINK_POLL_MS), [&] { return events != seen; });
+                        } //endif
+                    } //endif
+                }
+                if (!job) {
+                    if (busy) this_thread::sleep_for(chrono::microseconds(100));
+                    continue;
+                } //endif
+
+                if (build) {
+                    auto mesh = make_shared<Batch_Mesh>();
+                    mesh->shape = job->shape;
+                    mesh->file_name = job->file_name;
+                    if (job->file_name.empty()) { // Inline mesh read from a temporary file
+                        mesh->file_name = (filesystem::temp_directory_path() / ("erdos_daemon_" + to_string(getpid()) + "_" + to_string(job->id) + ".ply")).string();
+                        ofstream myFile(mesh->file_name);
+                        myFile << job->mesh_text;
+                        myFile.close();
+                    } //endif
+                    bool read = prepare_mesh(*mesh, job->options);
+                    if (job->file_name.empty()) {
+                        filesystem::remove(mesh->file_name);
+                        mesh->file_name = "inline";
+                    } //endif
+
+                    lock_guard<mutex> guard(lock);
+                    job->building = false;
+                    if (read) {
+                        meshes[job->mesh_key] = {mesh, ++uses};
+                        evict(meshes, CACHED_MESHES);
+                        job->mesh = mesh;
+                        if (!job->cancelled) start_job(*job);
+                    }
+                    else {
+                        job->unreadable = true;
+                    } //endif
+                    ++events;
+                    submitted.notify_all();
+                    continue;
+                } //endif
+
+                int k = job->taken++;
+                string name = job->shape + "_" + to_string(i) + (k ? "_t" + to_string(k) : "");
+                job->nodes += search(*job->mesh, job->options, task, *job->pool, *job->trails, i, name);
+                lock_guard<mutex> guard(lock);
+                --job->running;
+            } //endwhile
+        });
+    } //endfor
+
+    // Client connections
+    struct Client {
+        int fd;
+        string buffer;                      // Text received, not yet a whole line
+        shared_ptr<Daemon_Job> receiving;   // Job whose inline mesh is being received
+    };
+    vector<Client> clients;
+    vector<pair<int, string>> messages;     // Messages to send, with their connections
+    int next_id = 0;
+    bool shutdown = false;
+
+    // Submits a job whose mesh is known: its result replayed, or the job queued for the threads
+    auto submit = [&](shared_ptr<Daemon_Job> job) {
+        job->mesh_key = mesh_key(job->file_name, job->mesh_text, job->options.engine);
+        ostringstream key;
+        key << job->mesh_key << " " << job->shape << " " << job->options.engine << " " << job->options.beam_width << " " << job->options.solutions << " " << job->options.stop_first;
+        job->result_key = key.str();
+        string id = to_string(job->id);
+
+        lock_guard<mutex> guard(lock);
+        auto result = results.find(job->result_key);
+        if (result != results.end()) {
+            result->second.used = ++uses;
+            messages.push_back({job->fd, "ACCEPTED " + id + " result"});
+            for (auto& solution : result->second.solutions) {
+                messages.push_back({job->fd, "SOLUTION " + id + " " + solution});
+            } //endfor
+            messages.push_back({job->fd, "DONE " + id + " " + result->second.summary});
+            return;
+        } //endif
+        auto cached = meshes.find(job->mesh_key);
+        if (cached != meshes.end()) {
+            cached->second.used = ++uses;
+            job->mesh = cached->second.mesh;
+            start_job(*job);
+        } //endif
+        messages.push_back({job->fd, "ACCEPTED " + id + " " + (job->mesh ? "cached" : "new")});
+        jobs.push_back(job);
+        ++events;
+        submitted.notify_all();
+    };
+
+    cout << "Daemon listening on " << address << " with " << branches << " branches." << endl;
+    while (!shutdown || !jobs.empty()) {
+        vector<pollfd> fds;
+        fds.push_back({listener, POLLIN, 0});
+        for (auto& client : clients) {
+            fds.push_back({client.fd, POLLIN, 0});
+        } //endfor
+        poll(fds.data(), fds.size(), LINK_POLL_MS);
+        auto now = chrono::steady_clock::now();
+
+        // Requests of clients
+        for (int i = 0; i + 1 < fds.size(); ++i) {
+            Client& client = clients[i];
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            } //endif
+            vector<string> lines;
+            bool open = receive_lines(client.fd, client.buffer, lines);
+            for (auto& line : lines) {
+                if (client.receiving) { // Line of an inline mesh
+                    client.receiving->mesh_text += line + "\n";
+                    if (--client.receiving->mesh_lines == 0) {
+                        submit(client.receiving);
+                        client.receiving.reset();
+                    } //endif
+                    continue;
+                } //endif
+                istringstream stream(line);
+                string kind, error;
+                int id;
+                stream >> kind;
+                if (kind == "SEARCH") {
+                    auto job = make_shared<Daemon_Job>();
+                    if (!read_job_line(line, *job, error)) {
+                        messages.push_back({client.fd, "ERROR " + error});
+                        continue;
+                    } //endif
+                    job->id = ++next_id;
+                    job->fd = client.fd;
+                    if (shutdown) {
+                        client.receiving.reset();
+                        messages.push_back({client.fd, "ERROR daemon shutting down"});
+                    }
+                    else if (job->mesh_lines > 0) {
+                        client.receiving = job;
+                    }
+                    else {
+                        submit(job);
+                    } //endif
+                }
+                else if (kind == "CANCEL" && stream >> id) {
+                    lock_guard<mutex> guard(lock);
+                    bool known = false;
+                    for (auto& job : jobs) {
+                        if (job->id == id && job->fd == client.fd) {
+                            known = true;
+                            messages.push_back({client.fd, cancelled(*job)});
+                            cancel(*job);
+                        } //endif
+                    } //endfor
+                    if (!known) { // Never submitted by this client, or already done
+                        messages.push_back({client.fd, "ERROR unknown job"});
+                    } //endif
+                }
+                else if (kind == "SHUTDOWN") {
+                    shutdown = true;
+                    lock_guard<mutex> guard(lock);
+                    for (auto& job : jobs) {
+                        if (job->fd >= 0) messages.push_back({job->fd, cancelled(*job)});
+                        cancel(*job);
+                    } //endfor
+                }
+                else if (!kind.empty()) {
+                    messages.push_back({client.fd, "ERROR unknown request " + kind});
+                } //endif
+            } //endfor
+            if (!open) {
+                lock_guard<mutex> guard(lock);
+                for (auto& job : jobs) {
+                    if (job->fd == client.fd) cancel(*job);
+                } //endfor
+                close(client.fd);
+                client.fd = -1;
+            } //endif
+        } //endfor
+        for (auto& message : messages) {
+            send_line(message.first, message.second);
+        } //endfor
+        messages.clear();
+        erase_if(clients, [](Client& client) { return client.fd < 0; });
+
+        // Progress, A-trails and end of jobs
+        vector<shared_ptr<Daemon_Job>> done;
+        {
+            lock_guard<mutex> guard(lock);
+            // A job without a thread (mesh to build, or subtrees queued) while every thread is busy gets one handed
+            // back by the largest branch-bound search, unless it is larger itself
+            int busy = 0;
+            bool pending = false;
+            Daemon_Job* starved = nullptr;
+            Daemon_Job* largest = nullptr;
+            for (auto& job : jobs) {
+                busy += job->running + job->building;
+                if (job->running > 0 && job->pool->isYielding()) pending = true;
+                bool waiting = job->running == 0 && !job->building && !job->cancelled && !job->unreadable;
+                if (waiting && job->pool) waiting = !job->pool->isIdle() && !(job->pool->isFinished(0) && job->pool->isFinished(1));
+                if (waiting && (!starved || (starved->mesh && (!job->mesh || job->mesh->estimate < starved->mesh->estimate)))) starved = job.get();
+                if (job->running > 0 && job->options.engine == "bb" && (!largest || job->mesh->estimate > largest->mesh->estimate)) largest = job.get();
+            } //endfor
+            if (busy >= branches && !pending && starved && largest && (!starved->mesh || starved->mesh->estimate < largest->mesh->estimate)) {
+                largest->pool->yield();
+            } //endif
+
+            for (auto& job : jobs) {
+                string id = to_string(job->id);
+                if (!job->pool) {
+                    if (job->unreadable || (job->cancelled && !job->building)) done.push_back(job);
+                    continue;
+                } //endif
+                if (job->timeout > 0 && !job->timed_out && !job->cancelled && now - job->start > chrono::duration<double>(job->timeout)) {
+                    job->timed_out = true;
+                    job->pool->finish(0);
+                    job->pool->finish(1);
+                } //endif
+                if (job->running == 0 && (job->pool->isIdle() || (job->pool->isFinished(0) && job->pool->isFinished(1)))) {
+                    done.push_back(job);
+                    continue;
+                } //endif
+                for (int color = 0; color < 2; ++color) {
+                    vector<string> files = job->trails->getTrailFiles(color);
+                    for (; job->reported[color] < files.size(); ++job->reported[color]) {
+                        job->solutions.push_back(string(color ? "red " : "blue ") + files[job->reported[color]]);
+                        messages.push_back({job->fd, "SOLUTION " + id + " " + job->solutions.back()});
+                    } //endfor
+                } //endfor
+                if (now - job->progress >= chrono::seconds(PROGRESS_SECONDS)) {
+                    job->progress = now;
+                    messages.push_back({job->fd, "PROGRESS " + id + " " + to_string(max<unsigned long long int>(job->nodes, job->pool->getNodeCount())) + " " + to_string(chrono::duration<double>(now - job->start).count())});
+                } //endif
+            } //endfor
+            erase_if(jobs, [&done](auto& job) { return find(done.begin(), done.end(), job) != done.end(); });
+        }
+        for (auto& job : done) {
+            string id = to_string(job->id);
+            bool solved = false;
+            if (job->trails) {
+                job->trails->close();
+                for (int color = 0; color < 2; ++color) {
+                    vector<string> files = job->trails->getTrailFiles(color);
+                    for (; job->reported[color] < files.size(); ++job->reported[color]) {
+                        job->solutions.push_back(string(color ? "red " : "blue ") + files[job->reported[color]]);
+                        messages.push_back({job->fd, "SOLUTION " + id + " " + job->solutions.back()});
+                    } //endfor
+                } //endfor
+            } //endif
+            for (auto& solution : job->solutions) {
+                solved = solved || solution.find("_no_crossing_staples") != string::npos;
+            } //endfor
+            string status = job->unreadable ? "unreadable" : job->cancelled ? "cancelled" : solved ? "solved" : job->timed_out ? "timeout" : "unsolved";
+            double seconds = job->pool ? chrono::duration<double>(now - job->start).count() : 0;
+            string summary = status + " " + to_string(job->nodes) + " " + to_string(seconds);
+            if (!job->cancelled) {
+                messages.push_back({job->fd, "DONE " + id + " " + summary});
+            } //endif
+            {
+                lock_guard<mutex> guard(console_lock);
+                cout << "Job " << id << " (" << job->shape << "): " << summary << endl;
+            }
+
+            // Results of searches that ran to their end are kept
+            if (status == "solved" || status == "unsolved") {
+                lock_guard<mutex> guard(lock);
+                results[job->result_key] = {job->solutions, summary, ++uses};
+                evict(results, CACHED_RESULTS);
+            } //endif
+        } //endfor
+        for (auto& message : messages) {
+            if (message.first >= 0) send_line(message.first, message.second);
+        } //endfor
+        messages.clear();
+
+        // New clients
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) clients.push_back({fd, "", nullptr});
+        } //endif
+    } //endwhile
+
+    for (auto& thread : threads) {
+        thread.request_stop();
+    } //endfor
+    threads.clear();
+    for (auto& client : clients) {
+        close(client.fd);
+    } //endfor
+    close(listener);
+    if (address.rfind("unix:", 0) == 0) {
+        unlink(address.substr(5).c_str());
+    } //endif
+    cout << "Daemon served " << next_id << " job(s)." << endl;
+    return 0;
+#endif
+}
@@ -0,0 +1,52 @@
+#ifndef RATS_DAEMON_SEARCH_H
+#define RATS_DAEMON_SEARCH_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <functional>
+
+using namespace std;
+
+const int PROGRESS_SECONDS = 1;         // Seconds between progress messages of a daemon job
+const int CACHED_MESHES = 32;           // Most built meshes a daemon keeps between jobs
+const int CACHED_RESULTS = 1024;        // Most job results a daemon keeps for repeated jobs
+
+/*
+ * Search requested from a daemon by a client connection: a mesh (PLY file, or sent inline), shape name and
+ * search options, with the state of its search on the daemon's threads
+ */
+struct Daemon_Job {
+    int id = 0;
+    int fd = -1;                            // Client connection (-1 once the client is gone)
+    string shape;
+    string file_name;                       // PLY file (empty if the mesh was sent inline)
+    string mesh_text;                       // PLY text sent inline
+    int mesh_lines = 0;                     // Lines of the inline mesh still to be received
+    string mesh_key;                        // Key of the built mesh in the cache
+    string result_key;                      // Key of the result in the cache
+    Search_Options options;
+    double timeout = 0;                     // Seconds of search before the job is given up (0 for none)
+    shared_ptr<Batch_Mesh> mesh;            // Built mesh (shared with the cache and other jobs)
+    bool building = false;                  // Whether a thread builds the mesh
+    bool unreadable = false;                // Whether the mesh could not be read
+    unique_ptr<Search_Pool> pool;           // Open subtrees, taken by the daemon's threads
+    unique_ptr<Trail_Pipeline> trails;
+    int running = 0;                        // Threads searching subtrees of the job (guarded by the daemon)
+    atomic<int> taken = 0;                  // Subtrees taken, numbering A-trail files
+    atomic<unsigned long long int> nodes = 0;
+    bool cancelled = false;                 // Whether the client left or cancelled the job
+    bool timed_out = false;
+    int reported[2] = {0, 0};               // A-trail files of each color sent to the client
+    vector<string> solutions;               // Solution messages sent, kept with the result
+    chrono::steady_clock::time_point start; // Search started
+    chrono::steady_clock::time_point progress; // Last progress message
+};
+
+string mesh_key(const string& file_name, const string& mesh_text, const string& engine);
+bool read_job_line(const string& line, Daemon_Job& job, string& error);
+int run_daemon(string address, int branches, const function<unsigned long long int(Batch_Mesh&, Search_Options&, Search_Task&, Search_Pool&, Trail_Pipeline&, int, string)>& search);
+
+#endif //RATS_DAEMON_SEARCH_H
@@ -0,0 +1,672 @@
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <functional>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "trail_pipeline.h"
+#include "distributed_search.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <poll.h>
+#include <netdb.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+using namespace std;
+
+/*
+ * Writes an open subtree as one line, everything included so that another process searches exactly the same
+ * subtree: color, v and choice, then "|" before the vertex stack, the stabilizer and the refuted vertices
+ *
+ * @param task Open subtree
+ * @return string Line (without newline)
+ */
+string task_line(const Search_Task& task) {
+    ostringstream line;
+    line << task.color << " " << task.v << " " << task.choice << " |";
+    for (auto i : task.ver_stack) {
+        line << " " << i;
+    } //endfor
+    line << " |";
+    for (auto g : task.stabilizer) {
+        line << " " << g;
+    } //endfor
+    line << " |";
+    for (auto u : task.refuted) {
+        line << " " << u;
+    } //endfor
+    return line.str();
+}
+
+/*
+ * Reads an open subtree written by task_line()
+ *
+ * @param line Line
+ * @param task Open subtree read
+ * @return bool Whether or not the line is well formed
+ */
+bool read_task_line(const string& line, Search_Task& task) {
+    istringstream stream(line);
+    task = Search_Task();
+    if (!(stream >> task.color >> task.v >> task.choice) || task.color < 0 || task.color > 1) {
+        return false;
+    } //endif
+    vector<int>* lists[3] = {&task.ver_stack, &task.stabilizer, &task.refuted};
+    int list = -1;
+    string n;
+    while (stream >> n) {
+        if (n == "|") {
+            if (++list > 2) return false;
+        }
+        else if (list < 0) {
+            return false;
+        }
+        else {
+            lists[list]->push_back(stoi(n));
+        } //endif
+    } //endwhile
+    return list == 2;
+}
+
+/*
+ * Fingerprint of the reduced search instances, so that processes only share subtrees of the same search
+ * (same mesh, reduction and branching order)
+ *
+ * @param instances Reduced covering tree search instances of both face colors
+ * @return string Fingerprint (FNV-1a hash in hexadecimal)
+ */
+string instance_fingerprint(vector<Covering_Instance>& instances) {
+    unsigned long long int hash = 14695981039346656037ULL;
+    auto mix = [&hash](long long int value) {
+        hash = (hash ^ (unsigned long long int)value) * 1099511628211ULL;
+    };
+    for (auto& instance : instances) {
+        mix(instance.face_count);
+        mix(instance.infeasible);
+        for (auto v : instance.vertices) mix(v);
+        for (auto& faces : instance.vertex_faces) {
+            for (auto f : faces) mix(f);
+            mix(-1);
+        } //endfor
+        mix(instance.automorphisms.size());
+        for (auto& g : instance.automorphisms) {
+            for (auto u : g) mix(u);
+        } //endfor
+    } //endfor
+    ostringstream print;
+    print << hex << setw(16) << setfill('0') << hash;
+    return print.str();
+}
+
+#ifndef _WIN32
+/*
+ * Opens a socket on an address: "unix:<path>" for a Unix socket, "<host>:<port>" or "<port>" for TCP (all
+ * interfaces when listening, this machine when connecting if no host is given)
+ *
+ * @param address Address
+ * @param listening Whether to listen on the address (coordinator or daemon) or connect to it (worker)
+ * @return int Socket (-1 on failure)
+ */
+int open_socket(const string& address, bool listening) {
+    if (address.rfind("unix:", 0) == 0) {
+        string path = address.substr(5);
+        sockaddr_un local{};
+        if (path.empty() || path.size() >= sizeof(local.sun_path)) {
+            return -1;
+        } //endif
+        local.sun_family = AF_UNIX;
+        path.copy(local.sun_path, path.size());
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) {
+            return -1;
+        } //endif
+        if (listening) unlink(path.c_str());
+        int result = listening ? ::bind(fd, (sockaddr*)&local, sizeof(local)) : connect(fd, (sockaddr*)&local, sizeof(local));
+        if (result != 0 || (listening && listen(fd, SOMAXCONN) != 0)) {
+            close(fd);
+            return -1;
+        } //endif
+        return fd;
+    } //endif
+
+    size_t colon = address.rfind(':');
+    string host = colon == string::npos ? "" : address.substr(0, colon);
+    string port = colon == string::npos ? address : address.substr(colon + 1);
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = listening ? AI_PASSIVE : 0;
+    addrinfo* found;
+    if (getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &found) != 0) {
+        return -1;
+    } //endif
+    int fd = -1;
+    for (addrinfo* a = found; a != nullptr && fd < 0; a = a->ai_next) {
+        fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (fd < 0) {
+            continue;
+        } //endif
+        int on = 1;
+        if (listening) setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        else setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on)); // Messages are short lines
+        int result = listening ? ::bind(fd, a->ai_addr, a->ai_addrlen) : connect(fd, a->ai_addr, a->ai_addrlen);
+        if (result != 0 || (listening && listen(fd, SOMAXCONN) != 0)) {
+            close(fd);
+            fd = -1;
+        } //endif
+    } //endfor
+    freeaddrinfo(found);
+    return fd;
+}
+
+/*
+ * Sends one message line
+ *
+ * @param fd Socket
+ * @param line Message (without newline)
+ * @return bool Whether or not the line was sent
+ */
+bool send_line(int fd, const string& line) {
+    string data = line + "\n";
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = write(fd, data.data() + sent, data.size() - sent);
+        if (n <= 0) {
+            return false;
+        } //endif
+        sent += n;
+    } //endwhile
+    return true;
+}
+
+/*
+ * Reads what a readable socket has received, split into whole lines
+ *
+ * @param fd Socket
+ * @param buffer Text received before, not yet a whole line
+ * @param lines Whole lines received
+ * @return bool Whether or not the socket is still open
+ */
+bool receive_lines(int fd, string& buffer, vector<string>& lines) {
+    char data[4096];
+    ssize_t n = read(fd, data, sizeof(data));
+    if (n <= 0) {
+        return false;
+    } //endif
+    buffer.append(data, n);
+    size_t end;
+    while ((end = buffer.find('\n')) != string::npos) {
+        lines.push_back(buffer.substr(0, end));
+        buffer.erase(0, end + 1);
+    } //endwhile
+    return true;
+}
+
+/*
+ * Connection of a worker process to the coordinator
+ */
+struct Worker_Link {
+    int fd = -1;
+    int id = 0;
+    string buffer;                  // Text received, not yet a whole line
+    bool welcomed = false;          // Whether the worker searches the same instances
+    bool waiting = false;           // Whether the worker has searched every subtree it took and wants another
+    bool stopped = false;           // Whether the worker reported its statistics after the search
+    int branches = 0;
+    vector<Search_Task> lease;      // Subtrees taken since the worker last waited, searched again if it is lost
+    unsigned long long int nodes = 0;
+    double seconds = 0;
+    chrono::steady_clock::time_point heard;     // Last message received
+    chrono::steady_clock::time_point asked;     // Last request to donate a subtree
+};
+#endif
+
+/*
+ * Coordinator of a search distributed over worker processes (on this machine or others). It holds the open
+ * subtrees not yet taken (the frontier) and hands one out whenever a worker has searched everything it took;
+ * once the frontier is empty, busy workers are asked to donate a subtree split off their search (the "No"
+ * branch nearest the root, about half of what they have left) for the waiting ones. Workers route and write
+ * their own A-trails and report them; a color is finished everywhere once as many as wanted are reported
+ * (--solutions, or the first of either color with --stop-first). Subtrees taken by a worker that disconnects
+ * or falls silent go back to the frontier, so preempted workers may simply rejoin.
+ *
+ * @param address Address to listen on ("unix:<path>", "<host>:<port>" or "<port>")
+ * @param instances Reduced covering tree search instances of both face colors
+ * @param tasks Open subtrees to start from
+ * @param options Covering tree search settings (stop policy)
+ * @param shape Shape name for checkpoint files
+ * @param useCheckPoints Whether or not to write the frontier (and subtrees taken) as a checkpoint file
+ * @return int Exit status
+ */
+int run_coordinator(string address, vector<Covering_Instance>& instances, vector<Search_Task>& tasks, Search_Options& options, string shape, bool useCheckPoints) {
+#ifdef _WIN32
+    cerr << "Distributed search needs POSIX sockets, which are not available on this system." << endl;
+    return 1;
+#else
+    signal(SIGPIPE, SIG_IGN);
+    int listener = open_socket(address, true);
+    if (listener < 0) {
+        cerr << "Could not listen on " << address << "." << endl;
+        return 1;
+    } //endif
+
+    string fingerprint = instance_fingerprint(instances);
+    deque<Search_Task> frontier(tasks.begin(), tasks.end());
+    vector<Worker_Link> links;
+    vector<Worker_Link> gone;               // Workers disconnected, with their statistics
+    vector<vector<string>> trail_files(2);  // A-trails reported for each color
+    bool finished[2] = {false, false};
+    int next_id = 0;
+    bool over = false;
+    auto over_since = chrono::steady_clock::now();
+    auto checkpointed = chrono::steady_clock::now();
+    cout << "Coordinating " << frontier.size() << " open subtree(s) on " << address << ", waiting for workers." << endl;
+
+    auto finish = [&](int color) {
+        if (finished[color]) {
+            return;
+        } //endif
+        finished[color] = true;
+        for (auto& link : links) {
+            if (link.welcomed) send_line(link.fd, "FINISH " + to_string(color));
+        } //endfor
+    };
+    auto drop = [&](Worker_Link& link, string reason) {
+        int requeued = 0;
+        for (auto task = link.lease.rbegin(); task != link.lease.rend(); ++task) {
+            if (!finished[task->color]) {
+                frontier.push_front(*task);
+                ++requeued;
+            } //endif
+        } //endfor
+        if (link.welcomed && !link.stopped) {
+            cout << "Worker " << link.id << " " << reason << ", " << requeued << " subtree(s) back to the frontier." << endl;
+        } //endif
+        close(link.fd);
+        link.fd = -1;
+    };
+
+    while (!over || (!links.empty() && chrono::steady_clock::now() - over_since < chrono::seconds(WORKER_TIMEOUT_SECONDS))) {
+        vector<pollfd> fds;
+        fds.push_back({listener, POLLIN, 0});
+        for (auto& link : links) {
+            fds.push_back({link.fd, POLLIN, 0});
+        } //endfor
+        poll(fds.data(), fds.size(), LINK_POLL_MS);
+        auto now = chrono::steady_clock::now();
+
+        // Messages of workers
+        for (int i = 0; i + 1 < fds.size(); ++i) {
+            Worker_Link& link = links[i];
+            if (!(fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            } //endif
+            vector<string> lines;
+            bool open = receive_lines(link.fd, link.buffer, lines);
+            link.heard = now;
+            for (auto& line : lines) {
+                istringstream stream(line);
+                string kind, rest;
+                stream >> kind;
+                if (kind == "HELLO") {
+                    string print;
+                    stream >> print >> link.branches;
+                    if (print != fingerprint) {
+                        send_line(link.fd, "REJECT the worker reduced another search (same PLY file and engine needed)");
+                        cout << "Worker " << link.id << " rejected: different search instances." << endl;
+                        open = false;
+                        break;
+                    } //endif
+                    link.welcomed = true;
+                    send_line(link.fd, "WELCOME " + to_string(link.id));
+                    for (int color = 0; color < 2; ++color) {
+                        if (finished[color]) send_line(link.fd, "FINISH " + to_string(color));
+                    } //endfor
+                    if (over) send_line(link.fd, "STOP");
+                    cout << "Worker " << link.id << " joined with " << link.branches << " branches." << endl;
+                }
+                else if (!link.welcomed) {
+                    open = false;
+                    break;
+                }
+                else if (kind == "WORK") { // Every subtree taken so far is searched
+                    link.lease.clear();
+                    link.waiting = true;
+                }
+                else if (kind == "DONATE") {
+                    Search_Task task;
+                    getline(stream, rest);
+                    if (read_task_line(rest, task) && !finished[task.color]) {
+                        frontier.push_back(task); // Also part of the donor's subtrees, searched again if the donor is lost
+                    } //endif
+                }
+                else if (kind == "SOLVED") {
+                    int color;
+                    string file;
+                    if (stream >> color >> file && (color == 0 || color == 1)) {
+                        trail_files[color].push_back(file);
+                        cout << (color ? "Red" : "Blue") << " A-trail routed by worker " << link.id << ": " << file << endl;
+                        if (trail_files[color].size() >= options.solutions || options.stop_first) finish(color);
+                        if (options.stop_first) finish((color + 1) % 2);
+                    } //endif
+                }
+                else if (kind == "STATS") {
+                    stream >> link.nodes >> link.seconds;
+                    link.stopped = true;
+                } //endif
+            } //endfor
+            if (!open) {
+                drop(link, "disconnected");
+            } //endif
+        } //endfor
+
+        // Workers silent for too long (preempted without closing their connection)
+        for (auto& link : links) {
+            if (link.fd >= 0 && now - link.heard > chrono::seconds(WORKER_TIMEOUT_SECONDS)) {
+                drop(link, "timed out");
+            } //endif
+        } //endfor
+        for (int i = 0; i < links.size(); ++i) {
+            if (links[i].fd < 0) {
+                gone.push_back(links[i]);
+                links.erase(links.begin() + i);
+                --i;
+            } //endif
+        } //endfor
+
+        // New workers
+        if (fds[0].revents & POLLIN) {
+            int fd = accept(listener, nullptr, nullptr);
+            if (fd >= 0) {
+                int on = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+                Worker_Link link;
+                link.fd = fd;
+                link.id = next_id++;
+                link.heard = now;
+                link.asked = now;
+                links.push_back(link);
+            } //endif
+        } //endif
+        if (over) {
+            continue;
+        } //endif
+
+        // Subtrees of finished colors are dropped
+        for (int i = 0; i < frontier.size(); ++i) {
+            if (finished[frontier[i].color]) {
+                frontier.erase(frontier.begin() + i);
+                --i;
+            } //endif
+        } //endfor
+
+        // Subtrees handed to waiting workers, or else donations asked of busy ones
+        int waiting = 0;
+        int welcomed = 0;
+        for (auto& link : links) {
+            if (link.welcomed && link.waiting && !frontier.empty()) {
+                if (send_line(link.fd, "TASK " + task_line(frontier.front()))) {
+                    link.lease.push_back(frontier.front());
+                    link.waiting = false;
+                    frontier.pop_front();
+                } //endif
+            } //endif
+            welcomed += link.welcomed;
+            waiting += link.welcomed && link.waiting;
+        } //endfor
+        if (waiting > 0 && frontier.empty()) {
+            for (auto& link : links) {
+                if (link.welcomed && !link.waiting && now - link.asked >= chrono::milliseconds(SPLIT_REQUEST_MS)) {
+                    send_line(link.fd, "SPLIT");
+                    link.asked = now;
+                } //endif
+            } //endfor
+        } //endif
+
+        // Frontier and subtrees taken, as a checkpoint file from which any run resumes
+        if (useCheckPoints && now - checkpointed >= chrono::seconds(CHECKPOINT_SECONDS)) {
+            ofstream myFile("covering_tree_" + shape + "_coordinator_checkpoint.txt");
+            auto write = [&myFile](Search_Task& task) {
+                for (auto i : task.ver_stack) {
+                    myFile << i << " ";
+                } //endfor
+                myFile << "| " << task.v << " " << task.choice << " " << task.color << " " << 0 << endl;
+            };
+            for (auto& task : frontier) write(task);
+            for (auto& link : links) {
+                for (auto& task : link.lease) {
+                    if (!finished[task.color]) write(task);
+                } //endfor
+            } //endfor
+            myFile.close();
+            checkpointed = now;
+        } //endif
+
+        // Search over once both colors are finished, or every worker waits with nothing left to hand out
+        if ((finished[0] && finished[1]) || (frontier.empty() && waiting == welcomed)) {
+            over = true;
+            over_since = now;
+            for (auto& link : links) {
+                if (link.welcomed) send_line(link.fd, "STOP");
+            } //endfor
+        } //endif
+    } //endwhile
+
+    // Workers still connected (without statistics if they did not report in time)
+    for (auto& link : links) {
+        close(link.fd);
+        gone.push_back(link);
+    } //endfor
+    close(listener);
+    if (address.rfind("unix:", 0) == 0) {
+        unlink(address.substr(5).c_str());
+    } //endif
+
+    // Summary
+    unsigned long long int nodes = 0;
+    int lost = 0;
+    for (auto& link : gone) {
+        if (!link.welcomed) {
+            continue;
+        } //endif
+        if (!link.stopped) {
+            ++lost;
+            continue;
+        } //endif
+        nodes += link.nodes;
+        cout << "Worker " << link.id << ": " << link.nodes << " search nodes, " << link.seconds << "s"
+             << (link.seconds > 0 ? " (" + to_string((unsigned long long int)(link.nodes / link.seconds)) + " nodes/s)" : "") << "." << endl;
+    } //endfor
+    cout << "Distributed search: " << next_id << " worker connection(s), " << lost << " lost, " << nodes << " search nodes reported." << endl;
+    for (int color = 0; color < 2; ++color) {
+        if (trail_files[color].empty() && options.stop_first && !trail_files[(color + 1) % 2].empty()) {
+            cout << (color ? "Red" : "Blue") << " search stopped at the first A-trail without crossing staples." << endl;
+        }
+        else if (trail_files[color].empty()) {
+            cout << "No " << (color ? "red" : "blue") << " A-trail without crossing staples found." << endl;
+        } //endif
+    } //endfor
+    return 0;
+#endif
+}
+
+/*
+ * Worker of a search distributed by a coordinator: its branches search the subtrees the coordinator hands out
+ * (sharing them as in a parallel run), ask for more once everything taken is searched, and split off subtrees
+ * when the coordinator asks for a donation. A-trails are routed and written here, named with "w" and the
+ * worker number after the shape name, and reported to the coordinator. If the connection is lost, the
+ * subtrees being searched are dropped (the coordinator hands them out again) and the worker reconnects.
+ *
+ * @param address Address of the coordinator
+ * @param instances Reduced covering tree search instances of both face colors
+ * @param eg Embedded graph
+ * @param adjL Vertex-to-edge adjacency list
+ * @param options Covering tree search settings (stop policy)
+ * @param branches Number of branches/threads
+ * @param shape Shape name for output files
+ * @param search Searches the subtrees of a pool on all branches, routing A-trails through a pipeline (output
+ * files named after the given name), and gives the number of search nodes
+ * @return int Exit status
+ */
+int run_worker(string address, vector<Covering_Instance>& instances, CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, Search_Options& options, int branches, string shape,
+               const function<unsigned long long int(Search_Pool&, Trail_Pipeline&, string)>& search) {
+#ifdef _WIN32
+    cerr << "Distributed search needs POSIX sockets, which are not available on this system." << endl;
+    return 1;
+#else
+    signal(SIGPIPE, SIG_IGN);
+    string fingerprint = instance_fingerprint(instances);
+    while (true) {
+        // Connection, retried until the coordinator answers
+        int fd;
+        auto trying = chrono::steady_clock::now();
+        while ((fd = open_socket(address, false)) < 0) {
+            if (chrono::steady_clock::now() - trying > chrono::seconds(RECONNECT_SECONDS)) {
+                cerr << "Could not reach the coordinator at " << address << "." << endl;
+                return 1;
+            } //endif
+            this_thread::sleep_for(chrono::seconds(1));
+        } //endwhile
+        string buffer;
+        vector<string> lines;
+        send_line(fd, "HELLO " + fingerprint + " " + to_string(branches));
+        pollfd answer = {fd, POLLIN, 0};
+        while (lines.empty() && poll(&answer, 1, WORKER_TIMEOUT_SECONDS * 1000) > 0 && receive_lines(fd, buffer, lines)) {
+        } //endwhile
+        istringstream welcome(lines.empty() ? "" : lines.front());
+        string kind;
+        int id = -1;
+        welcome >> kind >> id;
+        if (kind == "REJECT") {
+            cerr << "Coordinator refused this worker: " << lines.front().substr(7) << "." << endl;
+            close(fd);
+            return 1;
+        }
+        else if (kind != "WELCOME") {
+            close(fd);
+            this_thread::sleep_for(chrono::seconds(1));
+            continue;
+        } //endif
+        lines.erase(lines.begin());
+        cout << "Connected to the coordinator at " << address << " as worker " << id << "." << endl;
+
+        // Branches search a pool linked to the coordinator
+        Search_Pool pool(branches, options.solutions, options.stop_first);
+        pool.link(true);
+        Trail_Pipeline trails(eg, adjL, instances, pool, branches / BRANCHES_PER_TRAIL_WORKER);
+        unsigned long long int nodes = 0;
+        auto started = chrono::steady_clock::now();
+        jthread searcher([&] { nodes = search(pool, trails, shape + "_w" + to_string(id)); });
+
+        bool connected = true;
+        bool stopped = false;   // Search over for the coordinator
+        bool requested = false; // More work asked for, none received yet
+        int reported[2] = {0, 0};  // A-trails reported for each color
+        auto heartbeat = chrono::steady_clock::now();
+        while (connected && !stopped) {
+            for (auto& line : lines) {
+                istringstream stream(line);
+                string rest;
+                stream >> kind;
+                if (kind == "TASK") {
+                    Search_Task task;
+                    getline(stream, rest);
+                    if (read_task_line(rest, task)) {
+                        pool.push(task);
+                        requested = false;
+                    } //endif
+                }
+                else if (kind == "SPLIT") {
+                    pool.want();
+                }
+                else if (kind == "FINISH") {
+                    int color;
+                    if (stream >> color && (color == 0 || color == 1)) pool.finish(color);
+                }
+                else if (kind == "STOP") {
+                    stopped = true;
+                } //endif
+            } //endfor
+            lines.clear();
+
+            // Subtrees split off for the coordinator
+            Search_Task task;
+            while (connected && pool.take(task)) {
+                connected = send_line(fd, "DONATE " + task_line(task));
+            } //endwhile
+
+            // A-trails routed here
+            for (int color = 0; color < 2; ++color) {
+                if (!trails.isRouted(color)) {
+                    continue;
+                } //endif
+                vector<string> files = trails.getTrailFiles(color);
+                for (; connected && reported[color] < files.size(); ++reported[color]) {
+                    connected = send_line(fd, "SOLVED " + to_string(color) + " " + files[reported[color]]);
+                } //endfor
+            } //endfor
+
+            // More work once everything taken is searched, otherwise a sign of life now and then
+            auto now = chrono::steady_clock::now();
+            if (connected && !requested && !stopped && pool.isIdle()) {
+                pool.link(true); // Donations asked for meanwhile are moot
+                requested = true;
+                connected = send_line(fd, "WORK");
+                heartbeat = now;
+            }
+            else if (connected && now - heartbeat >= chrono::seconds(HEARTBEAT_SECONDS)) {
+                connected = send_line(fd, "ALIVE");
+                heartbeat = now;
+            } //endif
+
+            pollfd messages = {fd, POLLIN, 0};
+            if (connected && poll(&messages, 1, LINK_POLL_MS) > 0) {
+                connected = receive_lines(fd, buffer, lines);
+            } //endif
+        } //endwhile
+
+        // Subtrees left are dropped: the search is over, or the coordinator hands them out again
+        if (!stopped) {
+            lock_guard<mutex> guard(console_lock);
+            cout << "Lost the coordinator at " << address << ", reconnecting." << endl;
+        } //endif
+        pool.finish(0);
+        pool.finish(1);
+        pool.link(false);
+        searcher.join();
+        trails.close();
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        if (stopped) {
+            for (int color = 0; color < 2; ++color) { // A-trails written since the last report
+                vector<string> files = trails.getTrailFiles(color);
+                for (; reported[color] < files.size(); ++reported[color]) {
+                    send_line(fd, "SOLVED " + to_string(color) + " " + files[reported[color]]);
+                } //endfor
+            } //endfor
+            send_line(fd, "STATS " + to_string(nodes) + " " + to_string(seconds));
+            close(fd);
+            return 0;
+        } //endif
+        close(fd);
+    } //endwhile
+#endif
+}
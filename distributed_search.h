@@ -0,0 +1,29 @@
+#ifndef RATS_DISTRIBUTED_SEARCH_H
+#define RATS_DISTRIBUTED_SEARCH_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <functional>
+
+using namespace std;
+
+const int LINK_POLL_MS = 20;            // Milliseconds between polls of the sockets of a distributed search
+const int SPLIT_REQUEST_MS = 200;       // Milliseconds between requests to the same worker to donate a subtree
+const int HEARTBEAT_SECONDS = 5;        // Seconds between messages of a worker while it searches
+const int WORKER_TIMEOUT_SECONDS = 30;  // Seconds of silence after which the coordinator gives a worker up
+const int RECONNECT_SECONDS = 300;      // Seconds a worker keeps trying to reach the coordinator
+
+#ifndef _WIN32
+int open_socket(const string& address, bool listening);
+bool send_line(int fd, const string& line);
+bool receive_lines(int fd, string& buffer, vector<string>& lines);
+#endif
+string task_line(const Search_Task& task);
+bool read_task_line(const string& line, Search_Task& task);
+string instance_fingerprint(vector<Covering_Instance>& instances);
+int run_coordinator(string address, vector<Covering_Instance>& instances, vector<Search_Task>& tasks, Search_Options& options, string shape, bool useCheckPoints);
+int run_worker(string address, vector<Covering_Instance>& instances, CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, Search_Options& options, int branches, string shape,
+               const function<unsigned long long int(Search_Pool&, Trail_Pipeline&, string)>& search);
+
+#endif //RATS_DISTRIBUTED_SEARCH_H
@@ -8,12 +8,32 @@
 #include <string>
 #include <set>
 #include <sstream>
+#include <iomanip>
 #include <cmath>
+#include <algorithm>
+#include <optional>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include "ply_to_embedding.h"
 #include "make_cc.h"
 #include "edgecode.h"
 #include "cc_embedded_graph.h"
+#include "kernelize.h"
+#include "face_forest.h"
 #include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "trail_pipeline.h"
+#include "shard_search.h"
+#include "distributed_search.h"
+#include "batch_search.h"
+#include "daemon_search.h"
+#include "td_covering_tree.h"
+#include "ls_covering_tree.h"
+#include "cnf_covering_tree.h"
+#include "comp_covering_tree.h"
+#include "estimate_covering_tree.h"
 #include "find_a_trail.h"
 
 #ifdef USE_OPENMP
@@ -22,6 +42,374 @@
 
 using namespace std;
 
+/*
+ * Searches covering trees of one face color and hands them to the A-trail pipeline, one at a time until the
+ * stop policy of the pool finishes the face color (A-trails are routed and checked by the pipeline meanwhile).
+ * The first covering tree of a fresh search comes from the chosen engine; later ones (and all of them when
+ * resuming) come from a branch-bound search paused between covering trees.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param options Covering tree search engine and its settings
+ * @param crossing Whether or not every A-trail of the face color has crossing staples (only one is routed)
+ * @param task Open subtree to search (from the beginning if nothing is decided)
+ * @param ver_stack Covering tree vertices of the last covering tree found
+ * @param iterationCount Number of search nodes
+ * @param prunedCount Number of "Yes" decisions pruned as closing a cycle, added to
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @param name Name for A-trail output files
+ * @param shape Shape name for checkpoint files
+ * @param useCheckPoints Whether or not to produce checkpoint files
+ * @param pool Work pool shared with other threads, and its stop policy
+ * @param trails A-trail pipeline
+ * @return bool Whether or not a covering tree was found
+ */
+bool route_covering_trees(Covering_Instance& instance, Search_Options& options, bool crossing, Search_Task& task, vector<int>& ver_stack, unsigned long long int& iterationCount, unsigned long long int& prunedCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum, string name, string shape, bool useCheckPoints, Search_Pool& pool, Trail_Pipeline& trails) {
+    int color = instance.face_color;
+    optional<Covering_Tree_Generator> trees;
+    vector<int> skipped; // Covering tree found by another engine, not routed twice
+
+    // First covering tree
+    bool has_covering_tree;
+    bool fresh = task.v == -1 && task.ver_stack.empty() && task.refuted.empty();
+    if (fresh && (options.engine != "bb" || td_width(instance, TD_MAX_WIDTH) <= TD_MAX_WIDTH)) {
+        ver_stack.clear();
+        has_covering_tree = search_covering_tree(instance, options, ver_stack, iterationCount, prunedCount, start, branchNum, shape, useCheckPoints);
+        skipped = ver_stack;
+        sort(skipped.begin(), skipped.end());
+    }
+    else {
+        trees.emplace(instance, task, iterationCount, branchNum, shape, useCheckPoints);
+        trees->share(&pool);
+        has_covering_tree = trees->next(ver_stack, iterationCount, start);
+    } //endif
+
+    int search_count = 0;
+    bool has_next = has_covering_tree;
+    while (has_next) {
+        // Another branch (or an A-trail of this one) finished the face color meanwhile
+        if (pool.isFinished(color)) {
+            break;
+        } //endif
+
+        // Routed by the pipeline while the search goes on
+        Trail_Job job;
+        job.color = color;
+        job.branchNum = branchNum;
+        job.name = search_count ? name + "_s" + to_string(search_count) : name;
+        job.forced = crossing;
+        job.ver_stack = ver_stack;
+        trails.submit(job);
+        if (crossing) { // Every A-trail has crossing staples, one is enough
+            pool.finish(color);
+            break;
+        } //endif
+
+        // Next covering tree, in case A-trails so far have crossing staples (or more A-trails are wanted)
+        ++search_count;
+        if (!trees) {
+            trees.emplace(instance, task, iterationCount, branchNum, shape, useCheckPoints);
+            trees->share(&pool);
+        } //endif
+        has_next = trees->next(ver_stack, iterationCount, start);
+        if (has_next && !skipped.empty()) {
+            vector<int> sorted_stack = ver_stack;
+            sort(sorted_stack.begin(), sorted_stack.end());
+            if (sorted_stack == skipped) {
+                has_next = trees->next(ver_stack, iterationCount, start);
+            } //endif
+        } //endif
+    } //endwhile
+
+    if (trees) {
+        prunedCount += trees->getPrunedCount();
+    } //endif
+    return has_covering_tree;
+}
+
+/*
+ * Streams every covering tree of one face color (symmetric ones included) with its A-trail, one line each:
+ * color, whether the A-trail has crossing staples (0 or 1), covering tree vertices, "|" and the A-trail
+ * (vertices indexed by 0). Each covering tree of the reduced instance is listed as every covering tree of the
+ * original vertices it stands for (see original_choices()). Starting vertex stacks are dealt out to the
+ * branches as in the search.
+ *
+ * @param eg Embedded graph
+ * @param adjL Vertex-to-edge adjacency list
+ * @param instance Reduced covering tree search instance
+ * @param branches Number of branches/threads
+ * @param limit Most covering trees to list (0 for all)
+ * @param out Output stream
+ * @param crossing_free Number of A-trails without crossing staples listed
+ * @return unsigned long long int Number of covering trees listed
+ */
+unsigned long long int enumerate_covering_trees(CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, Covering_Instance& instance, int branches, unsigned long long int limit, ostream& out, unsigned long long int& crossing_free) {
+    int color = instance.face_color;
+    Covering_Instance unpruned = instance;
+    unpruned.automorphisms.clear(); // Symmetric covering trees are listed too
+
+    int depth = 0;
+    while ((1 << depth) < branches && depth < (int)instance.vertices.size()) ++depth;
+    unsigned long long int listed = 0;
+    crossing_free = 0;
+    bool more = true;
+    atomic<int> next = 0; // Next starting vertex stack
+    mutex listing; // Guards out, listed, crossing_free and more
+    parallel_branches(branches, [&](int) {
+        for (int binary = next++; binary < (1 << depth); binary = next++) {
+            // Starting vertex stack of this branch
+            vector<int> ver_stack;
+            for (int j = 0; j < depth; ++j) {
+                if ((binary >> j) & 1) {
+                    ver_stack.push_back(j);
+                } //endif
+            } //endfor
+            bool has_cycle;
+            instance_tree_test(unpruned, ver_stack, has_cycle);
+            if (has_cycle) {
+                continue;
+            } //endif
+
+            unsigned long long int iterationCount = 0;
+            auto start = chrono::high_resolution_clock::now();
+            Covering_Tree_Generator trees(unpruned, depth - 1, -1, ver_stack, iterationCount, binary, "", false);
+            bool cont = true;
+            while (cont && trees.next(ver_stack, iterationCount, start)) {
+                // Covering trees of the original vertices it stands for (classes, and vertices with a single colored face)
+                vector<vector<int>> choices;
+                original_choices(instance, ver_stack, choices);
+                vector<int> pick(choices.size(), 0);
+                bool has_pick = true;
+                while (cont && has_pick) {
+                    // Covering tree vertices
+                    vector<int> ver_choice;
+                    for (int k = 0; k < choices.size(); ++k) {
+                        if (choices[k][pick[k]] != -1) ver_choice.push_back(choices[k][pick[k]]);
+                    } //endfor
+
+                    // A-trail
+                    vector<Edge> a_trail;
+                    bool has_crossing_staples = false;
+                    if (!ver_choice.empty()) {
+                        find_ATrail(eg, a_trail, ver_choice, color, "");
+                        has_crossing_staples = check_crossing_staples(adjL, a_trail);
+                    } //endif
+
+                    ostringstream line;
+                    line << (color ? "red" : "blue") << " " << has_crossing_staples << " |";
+                    for (auto v : ver_choice) {
+                        line << " " << v;
+                    } //endfor
+                    line << " |";
+                    for (auto e : a_trail) {
+                        line << " " << e.getV1();
+                    } //endfor
+                    if (!a_trail.empty()) {
+                        line << " " << a_trail.back().getV2();
+                    } //endif
+                    line << "\n";
+
+                    {
+                        lock_guard<mutex> guard(listing);
+                        if (more) {
+                            out << line.str();
+                            ++listed;
+                            if (!has_crossing_staples) ++crossing_free;
+                            more = limit == 0 || listed < limit;
+                        } //endif
+                        cont = more;
+                    }
+
+                    // Next combination of original vertices
+                    has_pick = false;
+                    for (int k = 0; k < choices.size() && !has_pick; ++k) {
+                        has_pick = ++pick[k] < choices[k].size();
+                        if (!has_pick) pick[k] = 0;
+                    } //endfor
+                } //endwhile
+            } //endwhile
+        } //endfor
+    });
+    out << flush;
+    return listed;
+}
+
+/*
+ * Searches every mesh of a batch on one set of threads. Meshes are read and reduced in parallel, then each
+ * thread takes open subtrees from the meshes with the smallest estimated search first; a thread finding none
+ * asks the meshes being searched to split subtrees off for it, so the largest meshes get every idle thread.
+ * A mesh searched longer than its timeout is given up (the branch-bound search stops at its next poll of the
+ * pool; engines searching a whole color finish their search first).
+ *
+ * @param manifest Manifest file (see read_manifest())
+ * @param branches Number of threads
+ * @param options Covering tree search engine and its settings
+ * @param timeout Seconds of search of each mesh not given its own in the manifest (0 for none)
+ * @return int Exit status
+ */
+int run_batch(string manifest, int branches, Search_Options& options, double timeout) {
+    deque<Batch_Mesh> meshes;
+    if (read_manifest(manifest, timeout, meshes) < 0) {
+        cerr << "Failed to read batch manifest " << manifest << "." << endl;
+        return 1;
+    } //endif
+
+    // Meshes read and reduced in parallel
+    cout << "Reading and reducing " << meshes.size() << " meshes with " << branches << " branches ..." << endl;
+    atomic<int> next = 0;
+    parallel_branches(branches, [&](int) {
+        for (int m = next++; m < meshes.size(); m = next++) {
+            if (!prepare_mesh(meshes[m], options)) {
+                {
+                    lock_guard<mutex> guard(console_lock);
+                    cerr << "Failed to read ply file " << meshes[m].file_name << "." << endl;
+                }
+            } //endif
+        } //endfor
+    });
+
+    // Both colors of each mesh start as one open subtree each, smallest estimated search first
+    vector<int> order;
+    for (int m = 0; m < meshes.size(); ++m) {
+        Batch_Mesh& mesh = meshes[m];
+        if (!mesh.ready) {
+            continue;
+        } //endif
+        mesh.pool = make_unique<Search_Pool>(0, options.solutions, options.stop_first);
+        for (int color = 0; color < 2; ++color) {
+            vector<int> empty;
+            Search_Task task = search_task(mesh.instances[color], -1, 0, empty);
+            mesh.pool->push(task);
+        } //endfor
+        mesh.trails = make_unique<Trail_Pipeline>(mesh.eg, mesh.adjL, mesh.instances, *mesh.pool, 1);
+        order.push_back(m);
+    } //endfor
+    stable_sort(order.begin(), order.end(), [&meshes](int a, int b) { return meshes[a].estimate < meshes[b].estimate; });
+    cout << "Searching " << order.size() << " meshes with " << branches << " branches sharing them." << endl;
+
+    // Meshes searched too long are given up
+    mutex lock; // Guards idle threads and search times
+    jthread monitor([&](stop_token stop) {
+        while (!stop.stop_requested()) {
+            auto now = chrono::steady_clock::now();
+            for (auto m : order) {
+                Batch_Mesh& mesh = meshes[m];
+                bool active = mesh.running > 0 || !mesh.pool->isIdle();
+                lock_guard<mutex> guard(lock);
+                if (mesh.timeout > 0 && mesh.started && active && !mesh.timed_out && now - mesh.start > chrono::duration<double>(mesh.timeout)) {
+                    mesh.timed_out = true;
+                    mesh.pool->finish(0);
+                    mesh.pool->finish(1);
+                } //endif
+            } //endfor
+            this_thread::sleep_for(chrono::milliseconds(TIMEOUT_POLL_MS));
+        } //endwhile
+    });
+
+    int idle = 0;
+    parallel_branches(branches, [&](int i) {
+        set_engine_threads(1); // Engines searching a whole color stay on their thread
+        vector<int> taken(meshes.size(), 0);
+        vector<int> ver_stack;
+        unsigned long long int prunedCount = 0; // Decisions pruned as closing a cycle in every mesh searched
+        bool waiting = false;
+        while (true) {
+            bool found = false;
+            for (auto m : order) {
+                Batch_Mesh& mesh = meshes[m];
+                Search_Task task;
+                if (!mesh.pool->tryPop(task)) {
+                    continue;
+                } //endif
+                ++mesh.running;
+                {
+                    lock_guard<mutex> guard(lock);
+                    if (waiting) --idle;
+                    waiting = false;
+                    if (!mesh.started) mesh.start = chrono::steady_clock::now();
+                    mesh.started = true;
+                }
+                unsigned long long int iterationCount = 0;
+                auto start = chrono::high_resolution_clock::now();
+                string name = mesh.shape + "_" + to_string(i) + (taken[m] ? "_t" + to_string(taken[m]) : "");
+                ++taken[m];
+                route_covering_trees(mesh.instances[task.color], options, mesh.crossing[task.color], task, ver_stack,
+                                     iterationCount, prunedCount, start, i, name, mesh.shape, false, *mesh.pool, *mesh.trails);
+                mesh.nodes += iterationCount;
+                {
+                    lock_guard<mutex> guard(lock);
+                    mesh.end = max(mesh.end, chrono::steady_clock::now());
+                }
+                --mesh.running;
+                found = true;
+                break;
+            } //endfor
+            if (found) {
+                continue;
+            } //endif
+
+            // Nothing queued: over once every thread waits, otherwise meshes being searched split subtrees off
+            {
+                lock_guard<mutex> guard(lock);
+                if (!waiting) ++idle;
+                waiting = true;
+                if (idle == branches) {
+                    break;
+                } //endif
+            }
+            for (auto m : order) {
+                if (meshes[m].running > 0 && !meshes[m].pool->isHungry()) meshes[m].pool->want();
+            } //endfor
+            this_thread::sleep_for(chrono::microseconds(100));
+        } //endwhile
+        {
+            lock_guard<mutex> guard(console_lock);
+            cout << "Branch " << i << ": " << prunedCount << " decisions pruned as closing a cycle." << endl;
+        }
+    });
+    monitor.request_stop();
+    monitor.join();
+
+    for (auto m : order) {
+        meshes[m].trails->close();
+    } //endfor
+    write_batch_summary(manifest, meshes);
+    return 0;
+}
+
+/*
+ * Reads the open subtrees listed in checkpoint files, one per line, whichever branch wrote them
+ *
+ * @param instances Reduced covering tree search instances of both face colors
+ * @param checkpoints Checkpoint files
+ * @param tasks Open subtrees read
+ */
+void read_checkpoint_tasks(vector<Covering_Instance>& instances, vector<string>& checkpoints, vector<Search_Task>& tasks) {
+    for (int i = 0; i < checkpoints.size(); ++i) {
+        string line, n;
+        ifstream myFile;
+        myFile.open(checkpoints[i]);
+
+        // Read checkpoint file
+        while (myFile.is_open() && getline(myFile, line)) {
+            int v, choice, face_color;
+            vector<int> ver_stack;
+            istringstream stream(line);
+            while (stream >> n) {
+                if (n == "|") {
+                    break;
+                } //endif
+                ver_stack.push_back(stoi(n));
+            } //endwhile
+            if (!(stream >> v >> choice >> face_color)) {
+                continue;
+            } //endif
+            tasks.push_back(search_task(instances[face_color], v, choice, ver_stack));
+        } //endwhile
+        myFile.close();
+    } //endfor
+}
+
 int main(int argc, char *argv[]) {
     string file_name;                   // Target ply file
     string shape;                       // Desired shape name
@@ -38,6 +426,21 @@ int main(int argc, char *argv[]) {
     bool useCheckPoints = false;        // Whether or not to produce checkpoint files
     bool checkPointGiven = false;       // Whether or not checkpoint file is given
     vector<string> checkpoints;         // Checkpoint files
+    bool localSearch = false;           // Whether or not to try local search before exhaustive search
+    Search_Options options;             // Covering tree search engine and its settings
+    bool exportCNF = false;             // Whether or not to write covering tree searches as CNF
+    string solverCmd;                   // External SAT solver command run on CNF files
+    bool enumerate = false;             // Whether or not to list every covering tree instead of searching for one
+    unsigned long long int enumerateLimit = 0; // Most covering trees listed for each color (0 for all)
+    bool countTrees = false;            // Whether or not to count covering trees instead of searching for one
+    int shard = -1;                     // Shard of the search taken by this process (-1 for the whole search)
+    int shards = 0;                     // Number of shards (processes) sharing the search
+    bool merge = false;                 // Whether or not to merge shard results instead of searching
+    string coordinatorAddress;          // Address the coordinator of a distributed search listens on (if this process is it)
+    string workerAddress;               // Address of the coordinator this worker process connects to
+    string batchManifest;               // Manifest of meshes searched together (batch mode)
+    double timeout = 0;                 // Seconds of search of each mesh of a batch (0 for none)
+    string daemonAddress;               // Address a daemon serving searches listens on (daemon mode)
 
     // Iteration tracking variables
     unsigned long long int iterationCount = 0;
@@ -48,24 +451,144 @@ int main(int argc, char *argv[]) {
     cout << "Welcome to ERDOS (Eulerian Routing of DNA Origami Scaffolds)! This program is used for automating the design of finding A-trail scaffold routings for toroidal DNA polyhedra. Please refer to https://github.com/JQBNguyen/ERDOS for more information and general-use guidelines." << endl;
     cout << string(50, '=') << endl;
 
+    // Options (given anywhere as --option) are set aside from positional arguments
+    vector<string> args = {argv[0]};
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--local-search") {
+            localSearch = true;
+        }
+        else if (arg.rfind("--engine=", 0) == 0) {
+            options.engine = arg.substr(9);
+            if (options.engine != "bb" && options.engine != "growth" && options.engine != "lds" && options.engine != "beam" && options.engine != "components") {
+                cerr << "Unknown engine " << options.engine << ", using bb." << endl;
+                options.engine = "bb";
+            } //endif
+        }
+        else if (arg.rfind("--beam-width=", 0) == 0) {
+            options.beam_width = max(1, stoi(arg.substr(13)));
+        }
+        else if (arg.rfind("--solutions=", 0) == 0) {
+            options.solutions = max(1, stoi(arg.substr(12)));
+        }
+        else if (arg == "--stop-first") {
+            options.stop_first = true;
+        }
+        else if (arg == "--pin-threads") {
+            options.pin_threads = true;
+        }
+        else if (arg == "--cnf") {
+            exportCNF = true;
+        }
+        else if (arg.rfind("--solver-cmd=", 0) == 0) {
+            exportCNF = true;
+            solverCmd = arg.substr(13);
+        }
+        else if (arg == "--enumerate") {
+            enumerate = true;
+        }
+        else if (arg.rfind("--enumerate=", 0) == 0) {
+            enumerate = true;
+            enumerateLimit = stoull(arg.substr(12));
+        }
+        else if (arg == "--count") {
+            countTrees = true;
+        }
+        else if (arg.rfind("--shard", 0) == 0) {
+            string value = arg.size() > 8 ? arg.substr(8) : (i + 1 < argc ? argv[++i] : "");
+            size_t slash = value.find('/');
+            if (slash == string::npos || stoi(value.substr(slash + 1)) < 1 || stoi(value.substr(0, slash)) < 0 || stoi(value.substr(0, slash)) >= stoi(value.substr(slash + 1))) {
+                cerr << "Shard should be given as --shard=<shard>/<shards> with 0 <= shard < shards." << endl;
+                exit(1);
+            } //endif
+            shard = stoi(value.substr(0, slash));
+            shards = stoi(value.substr(slash + 1));
+        }
+        else if (arg == "--merge") {
+            merge = true;
+        }
+        else if (arg.rfind("--coordinator=", 0) == 0) {
+            coordinatorAddress = arg.substr(14);
+        }
+        else if (arg.rfind("--worker=", 0) == 0) {
+            workerAddress = arg.substr(9);
+        }
+        else if (arg.rfind("--batch=", 0) == 0) {
+            batchManifest = arg.substr(8);
+        }
+        else if (arg.rfind("--daemon=", 0) == 0) {
+            daemonAddress = arg.substr(9);
+        }
+        else if (arg.rfind("--timeout=", 0) == 0) {
+            timeout = max(0.0, stod(arg.substr(10)));
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            cerr << "Unknown option " << arg << " ignored." << endl;
+        }
+        else {
+            args.push_back(arg);
+        } //endif
+    } //endfor
+
+    // Merges results of shards of a search: ./ERDOS --merge <given_shape_name> <number_of_shards>
+    if (merge) {
+        if (args.size() < 3) {
+            cerr << "Sample expected input: ./ERDOS --merge <given_shape_name> <number_of_shards>" << endl;
+            exit(1);
+        } //endif
+        return merge_shards(args[1], max(1, stoi(args[2])));
+    } //endif
+
+    // Searches every mesh of a manifest: ./ERDOS --batch=<manifest> <number_of_parallel_branches>
+    if (!batchManifest.empty()) {
+        if (args.size() < 2) {
+            cerr << "Sample expected input: ./ERDOS --batch=<manifest> <number_of_parallel_branches> [--timeout=<seconds>]" << endl;
+            exit(1);
+        } //endif
+        int status = run_batch(batchManifest, max(1, stoi(args[1])), options, timeout);
+        cout << "FINISHED" << endl;
+        cout << string(50, '=') << endl;
+        return status;
+    } //endif
+
+    // Serves searches to clients until asked to shut down: ./ERDOS --daemon=<address> <number_of_parallel_branches>
+    if (!daemonAddress.empty()) {
+        if (args.size() < 2) {
+            cerr << "Sample expected input: ./ERDOS --daemon=<address> <number_of_parallel_branches>" << endl;
+            exit(1);
+        } //endif
+        int status = run_daemon(daemonAddress, max(1, stoi(args[1])), [](Batch_Mesh& mesh, Search_Options& options, Search_Task& task, Search_Pool& pool, Trail_Pipeline& trails, int branchNum, string name) {
+            vector<int> ver_stack;
+            unsigned long long int iterationCount = 0;
+            unsigned long long int prunedCount = 0; // Not reported to clients
+            auto start = chrono::high_resolution_clock::now();
+            route_covering_trees(mesh.instances[task.color], options, mesh.crossing[task.color], task, ver_stack,
+                                 iterationCount, prunedCount, start, branchNum, name, name, false, pool, trails);
+            return iterationCount;
+        });
+        cout << "FINISHED" << endl;
+        cout << string(50, '=') << endl;
+        return status;
+    } //endif
+
     // All Command Arguments Given
-    if (argc >= 5) {
-        file_name = argv[1];
-        shape = argv[2];
-        branches = pow(2, (int)log2(stoi(argv[3])));
-        useCheckPoints = stoi(argv[4]);
+    if (args.size() >= 5) {
+        file_name = args[1];
+        shape = args[2];
+        branches = max(1, stoi(args[3]));
+        useCheckPoints = stoi(args[4]);
     } //endif
-    if (argc >= 6) {
+    if (args.size() >= 6) {
         checkPointGiven = true;
-        for (int i = 5; i < argc; ++i) {
-            checkpoints.emplace_back(argv[i]);
+        for (int i = 5; i < args.size(); ++i) {
+            checkpoints.emplace_back(args[i]);
         } //endfor
     } //endif
 
     // Insufficient Arguments Given
-    if (argc < 5) {
+    if (args.size() < 5) {
         cout << "Insufficient arguments given.\n";
-        cout << "Sample expected input: ./ERDOS <input_PLY_file> <given_shape_name> <number_of_parallel_branches> <produce_checkpoint_files> <list_of_given_checkpoint_files>(optional).\n";
+        cout << "Sample expected input: ./ERDOS <input_PLY_file> <given_shape_name> <number_of_parallel_branches> <produce_checkpoint_files> <list_of_given_checkpoint_files>(optional) [--local-search] [--engine=bb|growth|lds|beam|components] [--beam-width=<width>] [--solutions=<count>] [--stop-first] [--pin-threads] [--cnf] [--solver-cmd=<command>] [--enumerate[=<limit>]] [--count] [--shard=<shard>/<shards>] [--coordinator=<address>] [--worker=<address>] [--batch=<manifest> [--timeout=<seconds>]] [--daemon=<address>].\n";
         cout << "Proceed with manual input of files and options below." << endl;
 
         cerr << "Please input file path name (provided file should be of PLY format)." << endl;
@@ -83,7 +606,7 @@ int main(int argc, char *argv[]) {
             cerr << "Try again. Please input an integer." << endl;
             cin >> b;
         } //endwhile
-        branches = pow(2, (int)log2(b));
+        branches = max(1, b);
 
         cerr << "Do you want to produce checkpoint files (periodically store covering tree search information to save progress and rerun ERDOS at later times)? (Y/N)" << endl;
         char cp;
@@ -107,6 +630,12 @@ int main(int argc, char *argv[]) {
         } //endif
     }
 
+    // Output files of a shard are kept apart from those of other shards
+    string search_shape = shape;
+    if (shard >= 0) {
+        shape += "_shard" + to_string(shard);
+    } //endif
+
     // Reads ply file
     cout << string(50, '=') << endl;
     cout << "Parsing through provided PLY file to read polyhedron information (vertex, edge, face information) ..." << endl;
@@ -136,6 +665,7 @@ int main(int argc, char *argv[]) {
     cout << string(50, '=') << endl;
     cout << "Creating embedded graph representation of mesh for processing purposes ..." << endl;
     CC_Embedded_Graph eg = CC_Embedded_Graph(adjL);
+    cout << "There are " << eg.getRedAutomorphisms().size() << " (red) and " << eg.getBlueAutomorphisms().size() << " (blue) color-preserving symmetries of the mesh." << endl;
     cout << "FINISHED" << endl;
     cout << string(50, '=') << endl;
 
@@ -146,564 +676,335 @@ int main(int argc, char *argv[]) {
     cout << "FINISHED" << endl;
     cout << string(50, '=') << endl;
 
-    // Covering tree search
+    // Reduces covering tree search instances
     cout << string(50, '=') << endl;
-    cout << "Beginning covering tree search ..." << endl;
+    cout << "Reducing covering tree search for each face color (forcing, dropping and merging vertices) ..." << endl;
+    vector<Covering_Instance> instances(2);
+    vector<int> widths(2);
+    vector<long double> estimates(2);
+    vector<bool> crossing(2);
+    for (int color = 0; color < 2; ++color) {
+        kernelize(eg, color, v_order, instances[color]);
+        widths[color] = td_width(instances[color], TD_MAX_WIDTH);
+        cout << (color ? "Red" : "Blue") << ": " << instances[color].vertices.size() << " of " << eg.getVertexCount() << " vertices left to branch on, "
+             << instances[color].forced.size() << " forced, " << instances[color].dominated << " dominated, " << instances[color].face_count << " faces, "
+             << instances[color].automorphisms.size() << " symmetries" << (widths[color] <= TD_MAX_WIDTH ? ", treewidth at most " + to_string(widths[color]) : "") << (instances[color].infeasible ? " (no covering tree)" : "") << "." << endl;
+
+        // Branching order with smallest estimated search (branch-bound search only)
+        string ordering = "BFS";
+        vector<int> empty;
+        if (options.engine == "bb") {
+            estimates[color] = order_covering_tree(instances[color], ESTIMATE_PROBES, ordering);
+        }
+        else {
+            estimates[color] = estimate_search_size(instances[color], -1, empty, ESTIMATE_PROBES, 0);
+        } //endif
+        cout << (color ? "Red" : "Blue") << ": about " << (double)estimates[color] << " search nodes in " << ordering << " order." << endl;
 
-#ifdef USE_OPENMP
-    omp_set_num_threads(branches);
-    if (!checkPointGiven) { // Covering tree search from beginning
-        if (branches <= 1) { // Serial search
-            // User chooses which color face to search first
-            cout << "Input 1 (red) or 0 (blue)" << endl;
-            cin >> first_color;
-            while (first_color != 1 && first_color != 0) {
-                cout << "Input 1 (red) or 0 (blue)";
-                cin >> first_color;
-            } //endwhile
+        // A-trails of some colors have crossing staples whichever covering tree is found
+        crossing[color] = forced_crossing_staples(eg, adjL, color);
+        if (crossing[color]) {
+            cout << (color ? "Red" : "Blue") << ": every A-trail has crossing staples, only one covering tree will be searched for." << endl;
+        } //endif
+    } //endfor
+    cout << "FINISHED" << endl;
+    cout << string(50, '=') << endl;
 
-            vector<int> ver_choice;
-            int color = first_color;
+    // Counting covering trees (without routing A-trails)
+    if (countTrees && !checkPointGiven) {
+        cout << string(50, '=') << endl;
+        cout << "Counting covering trees for each face color ..." << endl;
+        set_engine_threads(branches);
+        for (int color = 0; color < 2; ++color) {
+            iterationCount = 0;
             start = chrono::high_resolution_clock::now();
+            long double count = count_covering_trees(instances[color], true, iterationCount, start, color);
+            iterationCount = 0;
+            start = chrono::high_resolution_clock::now();
+            long double searched = count_covering_trees(instances[color], false, iterationCount, start, color);
+            cout << setprecision(20) << (color ? "Red" : "Blue") << ": " << count << " covering trees (" << searched << " after reduction), "
+                 << (crossing[color] ? "all" : "none") << " with crossing staples." << endl;
+        } //endfor
+        cout << "FINISHED" << endl;
+        cout << string(50, '=') << endl;
+        return 0;
+    } //endif
 
-            // First face color search
-            bool has_covering_tree = bb_covering_tree(eg, -1, 1, ver_stack, first_color, v_order,
-                                                      iterationCount, start, 1, shape + "_1", useCheckPoints);
-            if (has_covering_tree) {
-                // Covering tree vertices
-                for (int j = 0; j < ver_stack.size(); ++j) {
-                    ver_choice.push_back(v_order[ver_stack[j]]);
-                } //endfor
-
-                // A-trail
-                bool has_crossing_staples = false;
-                if (!ver_choice.empty()) {
-                    find_ATrail(eg, a_trail, ver_choice, first_color, shape + "_1");
-                    has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                    write_atrail_to_file(a_trail, first_color, shape + "_1", has_crossing_staples);
-                } //endif
-
-                // Output vertex stack and covering tree vertices to console
-                cout << endl;
-                cout << "Covering tree found ..." << endl;
-                cout << "Vertex stack (" << (first_color ? "red" : "blue") << ") :";
-                for (auto v: ver_stack) {
-                    cout << v << " ";
-                } //endfor
-                cout << endl;
-                cout << "Covering tree vertices (" << (first_color ? "red" : "blue") << ") :";
-                for (auto v: ver_choice) {
-                    cout << v << " ";
-                } //endfor
-                cout << endl;
-
-                int search_count = 0;
-                // Continue Search if crossing staples found
-                while (has_crossing_staples) {
-                    ++search_count;
-                    cout << "Continuing search on branch 1 ..." << endl;
-                    int last_vertex = ver_stack[ver_stack.size() - 1];
-                    has_covering_tree = bb_covering_tree(eg, last_vertex, 0, ver_stack, first_color, v_order,
-                                                         iterationCount, start, 1, shape + "_1" + "_s" + to_string(search_count), useCheckPoints);
-                    if (has_covering_tree) {
-                        // Covering tree vertices
-                        for (int j = 0; j < ver_stack.size(); ++j) {
-                            ver_choice.push_back(v_order[ver_stack[j]]);
-                        } //endfor
-
-                        // A-trail
-                        if (!ver_choice.empty()) {
-                            find_ATrail(eg, a_trail, ver_choice, first_color, shape + "_s" + to_string(search_count));
-                            has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                            write_atrail_to_file(a_trail, first_color, shape + "_1" + "_s" + to_string(search_count), has_crossing_staples);
-                        } //endif
+    // Listing covering trees with their A-trails
+    if (enumerate && !checkPointGiven) {
+        cout << string(50, '=') << endl;
+        string o = "covering_trees_" + shape + ".txt";
+        cout << "Listing covering trees for each face color with their A-trails to " << o << " ..." << endl;
+        set_engine_threads(branches);
+        ofstream myFile(o);
+        myFile << "# color, crossing staples (1) or not (0) | covering tree vertices | A-trail" << endl;
+        for (int color = 0; color < 2; ++color) {
+            unsigned long long int crossing_free;
+            unsigned long long int listed = enumerate_covering_trees(eg, adjL, instances[color], branches, enumerateLimit, myFile, crossing_free);
+            cout << (color ? "Red" : "Blue") << ": " << listed << " covering trees listed, " << crossing_free << " A-trails without crossing staples." << endl;
+        } //endfor
+        myFile.close();
+        cout << "FINISHED" << endl;
+        cout << string(50, '=') << endl;
+        return 0;
+    } //endif
 
-                        // Output vertex stack and covering tree vertices to console
-                        cout << endl;
-                        cout << "Covering tree found ..." << endl;
-                        cout << "Vertex stack (" << (first_color ? "red" : "blue") << ") :";
-                        for (auto v: ver_stack) {
-                            cout << v << " ";
-                        } //endfor
-                        cout << endl;
-                        cout << "Covering tree vertices (" << (first_color ? "red" : "blue") << ") :";
-                        for (auto v: ver_choice) {
-                            cout << v << " ";
-                        } //endfor
-                        cout << endl;
-                    }
-                    else {
-                        #pragma omp critical
-                        {
-                            cout << "Could not find a-trail without crossing staples on branch 1" << endl;
-                        }
-                        break;
-                    }
-                }
-            }
-            else {
-                // Search second face color
+    // Local search for covering trees (incomplete, for meshes too large to search exhaustively)
+    if (localSearch && !checkPointGiven) {
+        cout << string(50, '=') << endl;
+        cout << "Beginning local search for covering trees with " << branches << " chain(s) ..." << endl;
+        bool routed = false;
+        for (int color = 0; color < 2 && !routed; ++color) {
+            for (int attempt = 0; attempt < LS_ATTEMPTS && !routed && !crossing[color]; ++attempt) {
                 ver_stack.clear();
-                ver_choice.clear();
-                iterationCount = 0;
-                start = chrono::high_resolution_clock::now();
-                has_covering_tree = bb_covering_tree(eg, -1, 1, ver_stack, (first_color + 1) % 2, v_order,
-                                                     iterationCount, start, 0, shape + "_0", useCheckPoints);
-                if (has_covering_tree) {
-                    color = (first_color + 1) % 2;
-                    // Covering tree vertices
-                    for (int j = 0; j < ver_stack.size(); ++j) {
-                        ver_choice.push_back(v_order[ver_stack[j]]);
-                    } //endfor
-
-                    // A-trail
-                    bool has_crossing_staples = false;
-                    if (!ver_choice.empty()) {
-                        find_ATrail(eg, a_trail, ver_choice, (first_color + 1) % 2, shape + "_0");
-                        has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                        write_atrail_to_file(a_trail, color, shape + "_0", has_crossing_staples);
-                    } //endfor
-
-                    // Output vertex stack and covering tree vertices to console
-                    cout << endl;
-                    cout << "Covering tree found ..." << endl;
-                    cout << "Vertex stack (" << ((first_color + 1) % 2 ? "red" : "blue") << ") :";
-                    for (auto v: ver_stack) {
-                        cout << v << " ";
-                    } //endfor
-                    cout << endl;
-                    cout << "Covering tree vertices (" << ((first_color + 1) % 2 ? "red" : "blue") << ") :";
-                    for (auto v: ver_choice) {
-                        cout << v << " ";
-                    } //endfor
-                    cout << endl;
-
-                    int search_count = 0;
-                    // Continue Search if crossing staples found
-                    while (has_crossing_staples) {
-                        ++search_count;
-                        cout << "Continuing search on branch 0 ..." << endl;
-                        int last_vertex = ver_stack[ver_stack.size() - 1];
-                        has_covering_tree = bb_covering_tree(eg, last_vertex, 0, ver_stack, (first_color + 1) % 2, v_order,
-                                                             iterationCount, start, 0, shape + "_0" + "_s" + to_string(search_count), useCheckPoints);
-                        if (has_covering_tree) {
-                            // Covering tree vertices
-                            for (int j = 0; j < ver_stack.size(); ++j) {
-                                ver_choice.push_back(v_order[ver_stack[j]]);
-                            } //endfor
-
-                            // A-trail
-                            if (!ver_choice.empty()) {
-                                find_ATrail(eg, a_trail, ver_choice, (first_color + 1) % 2, shape + "_0" + "_s" + to_string(search_count));
-                                has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                                write_atrail_to_file(a_trail, (first_color + 1) % 2, shape + "_0" + "_s" + to_string(search_count), has_crossing_staples);
-                            } //endif
-
-                            // Output vertex stack and covering tree vertices to console
-                            cout << endl;
-                            cout << "Covering tree found ..." << endl;
-                            cout << "Vertex stack (" << ((first_color + 1) % 2 ? "red" : "blue") << ") :";
-                            for (auto v: ver_stack) {
-                                cout << v << " ";
-                            } //endfor
-                            cout << endl;
-                            cout << "Covering tree vertices (" << ((first_color + 1) % 2 ? "red" : "blue") << ") :";
-                            for (auto v: ver_choice) {
-                                cout << v << " ";
-                            } //endfor
-                            cout << endl;
-                        }
-                        else {
-                            #pragma omp critical
-                            {
-                                cout << "Could not find a-trail without crossing staples on branch 0" << endl;
-                            }
-                            break;
-                        }
-                    }
-                }
-            }
-        } else {
-            // Searching for covering tree (parallelized)
-            #pragma omp parallel for shared(v_order, branches, eg) private(ver_stack, a_trail, iterationCount, start)
-            for (int i = 0; i < branches; ++i) {
-                int color = i % 2;
-
-                // Populate different starting ver_stack based on branch
-                int binary = i / 2;
-                for (int j = 0; j < (branches / 2); ++j) {
-                    if ((binary >> j) & 1) {
-                        ver_stack.push_back(j);
-                    } //endif
-                } //endfor
-
-                // Check starting covering tree validity
-                vector<vector<int>> covering_tree;
-                bool covers_all_colored_faces = full_tree_test(eg, ver_stack, color, covering_tree, v_order);
-                bool has_cycle = test_for_cycle(covering_tree);
-
-                // Stop branch condition
-                bool cont = true;
-                if (!has_cycle && covers_all_colored_faces) {
-                    cont = false;
-                } else if (has_cycle || eg.getVertexCount() <= ver_stack.size()) {
-                    cont = false;
-                    ver_stack.clear();
-                } //endif
-
-                int ver_stack_initial_count = ver_stack.size();
-
-                bool has_covering_tree;
-
-                // Find covering tree
-                if (cont) {
-                    // Start search at next vertex
-                    start = chrono::high_resolution_clock::now();
-                    has_covering_tree = bb_covering_tree(eg, log2(branches / 2), 1, ver_stack, color, v_order,
-                                                              iterationCount, start, i, shape, useCheckPoints);
-                    if (!has_covering_tree)
-                        has_covering_tree = bb_covering_tree(eg, log2(branches / 2), 0, ver_stack, color, v_order, iterationCount, start, i,
-                                         shape, useCheckPoints);
-
-                    // Clear initial vertex stack if no covering tree found
-                    if (ver_stack.size() == ver_stack_initial_count) {
-                        ver_stack.clear();
-                    } //endif
+                if (!ls_covering_tree(instances[color], ver_stack, branches, LS_ROUNDS, attempt)) {
+                    cout << "No " << (color ? "red" : "blue") << " covering tree found by local search." << endl;
+                    break;
                 } //endif
 
                 // Covering tree vertices
                 vector<int> ver_choice;
-                for (int j = 0; j < ver_stack.size(); ++j) {
-                    ver_choice.push_back(v_order[ver_stack[j]]);
-                } //endfor
+                map_to_original(instances[color], ver_stack, ver_choice);
 
                 // A-trail
-                bool has_crossing_staples = false;
-                if (!ver_choice.empty()) {
-                    find_ATrail(eg, a_trail, ver_choice, color, shape + "_" + to_string(i));
-                    has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                    write_atrail_to_file(a_trail, color, shape + "_" + to_string(i), has_crossing_staples);
-                } //endif
-
-                // Output vertex stack and covering tree vertices to console
-                #pragma omp critical
-                {
-                    cout << endl;
-                    cout << "Covering tree found ..." << endl;
-                    cout << "Vertex stack (" << (color ? "red" : "blue") << ") branch " << i << ": ";
-                    for (auto v: ver_stack) {
-                        cout << v << " ";
-                    } //endfor
-                    cout << endl;
-                    cout << "Covering tree vertices (" << (color ? "red" : "blue") << ") branch " << i << ": ";
-                    for (auto v: ver_choice) {
-                        cout << v << " ";
-                    } //endfor
-                    cout << endl;
-                }
-
-                int search_count = 0;
-                // Continue Search if crossing staples found
-                while (has_crossing_staples) {
-                    ++search_count;
-                    #pragma omp critical
-                    {
-                        cout << "Continuing search on branch" << i << " ..." << endl;
-                    }
-                    int last_vertex = ver_stack[ver_stack.size() - 1];
-                    has_covering_tree = bb_covering_tree(eg, last_vertex, 0, ver_stack, color, v_order,
-                                                         iterationCount, start, i, shape + "_" + to_string(i) + "_s" + to_string(search_count), useCheckPoints);
-                    if (has_covering_tree) {
-                        // Covering tree vertices
-                        for (int j = 0; j < ver_stack.size(); ++j) {
-                            ver_choice.push_back(v_order[ver_stack[j]]);
-                        } //endfor
-
-                        // A-trail
-                        if (!ver_choice.empty()) {
-                            find_ATrail(eg, a_trail, ver_choice, color, shape + "_" + to_string(i) + "_s" + to_string(search_count));
-                            has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                            write_atrail_to_file(a_trail, color, shape + "_" + to_string(i) + "_s" + to_string(search_count), has_crossing_staples);
-                        } //endif
-
-                        // Output vertex stack and covering tree vertices to console
-                        #pragma omp critical
-                        {
-                            cout << endl;
-                            cout << "Covering tree found ..." << endl;
-                            cout << "Vertex stack (" << (color ? "red" : "blue") << ") :";
-                            for (auto v: ver_stack) {
-                                cout << v << " ";
-                            } //endfor
-                            cout << endl;
-                            cout << "Covering tree vertices (" << (color ? "red" : "blue") << ") :";
-                            for (auto v: ver_choice) {
-                                cout << v << " ";
-                            } //endfor
-                            cout << endl;
-                        }
-                    }
-                    else {
-                        #pragma omp critical
-                        {
-                            cout << "Could not find a-trail without crossing staples on branch " << i << endl;
-                        }
-                        break;
-                    }
-                }
-
-            } //endfor
-        } //endif
-    }
-    else if (checkPointGiven) { // Start search from checkpoint file(s)
-        // Loop through given checkpoint files
-        #pragma omp parallel for shared(v_order, eg) private(ver_stack, a_trail, iterationCount, start)
-        for (int i = 0; i < checkpoints.size(); ++i) {
-            string line, n;
-            ifstream myFile;
-            myFile.open(checkpoints[i]);
-
-            int v, choice, face_color, branchNum;
-
-            // Read checkpoint file
-            if (myFile.is_open()) {
-                if (getline(myFile, line)) {
-                    istringstream stream(line);
-                    while (stream >> n) {
-                        if (n == "|") {
-                            break;
-                        } //endif
-                        ver_stack.push_back(stoi(n));
-                    } //endwhile
-                    stream >> n;
-                    v = stoi(n);
-                    stream >> n;
-                    choice = stoi(n);
-                    stream >> n;
-                    face_color = stoi(n);
-                    stream >> n;
-                    branchNum = stoi(n);
-                } //endif
-            } //endif
-            myFile.close();
-
-            start = chrono::high_resolution_clock::now();
-            bool has_covering_tree = bb_covering_tree(eg, v, choice, ver_stack, face_color, v_order,
-                                                          iterationCount, start, branchNum, shape + "_" + to_string(branchNum), useCheckPoints);
-
-            // Covering tree vertices
-            vector<int> ver_choice;
-            for (int j = 0; j < ver_stack.size(); ++j) {
-                ver_choice.push_back(v_order[ver_stack[j]]);
-            } //endfor
-
-            // A-trail
-            bool has_crossing_staples = false;
-            if (!ver_choice.empty()) {
-                find_ATrail(eg, a_trail, ver_choice, face_color, shape + "_" + to_string(branchNum));
-                has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                write_atrail_to_file(a_trail, face_color, shape + "_" + to_string(branchNum), has_crossing_staples);
-
-            } //endif
+                a_trail.clear();
+                find_ATrail(eg, a_trail, ver_choice, color, shape + "_ls" + to_string(attempt));
+                bool has_crossing_staples = check_crossing_staples(adjL, a_trail);
+                write_atrail_to_file(a_trail, color, shape + "_ls" + to_string(attempt), has_crossing_staples);
+                routed = !has_crossing_staples;
 
-            // Output vertex stack and covering tree vertices to console
-            #pragma omp critical
-            {
-                cout << endl;
-                cout << "Covering tree found ..." << endl;
-                cout << "Vertex stack (" << (face_color ? "red" : "blue") << ") branch " << branchNum << ": ";
-                for (auto v: ver_stack) {
-                    cout << v << " ";
-                } //endfor
+                // Output covering tree vertices to console
                 cout << endl;
-                cout << "Covering tree vertices (" << (face_color ? "red" : "blue") << ") branch " << branchNum << ": ";
+                cout << "Covering tree found by local search ..." << endl;
+                cout << "Covering tree vertices (" << (color ? "red" : "blue") << ") attempt " << attempt << ": ";
                 for (auto v: ver_choice) {
                     cout << v << " ";
                 } //endfor
                 cout << endl;
-            }
-
-            int search_count = 0;
-            // Continue Search if crossing staples found
-            while (has_crossing_staples) {
-                ++search_count;
-                #pragma omp critical
-                {
-                    cout << "Continuing search on branch" << i << " ..." << endl;
-                }
-                int last_vertex = ver_stack[ver_stack.size() - 1];
-                has_covering_tree = bb_covering_tree(eg, last_vertex, 0, ver_stack, face_color, v_order,
-                                                     iterationCount, start, branchNum, shape + "_" + to_string(branchNum) + "_s" + to_string(search_count), useCheckPoints);
-                if (has_covering_tree) {
-                    // Covering tree vertices
-                    for (int j = 0; j < ver_stack.size(); ++j) {
-                        ver_choice.push_back(v_order[ver_stack[j]]);
-                    } //endfor
-
-                    // A-trail
-                    if (!ver_choice.empty()) {
-                        find_ATrail(eg, a_trail, ver_choice, face_color, shape + "_" + to_string(i) + "_s" + to_string(search_count));
-                        has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                        write_atrail_to_file(a_trail, face_color, shape + "_" + to_string(branchNum) + "_s" + to_string(search_count), has_crossing_staples);
-                    } //endif
-
-                    #pragma omp critical
-                    {
-                        // Output vertex stack and covering tree vertices to console
-                        cout << endl;
-                        cout << "Covering tree found ..." << endl;
-                        cout << "Vertex stack (" << (face_color ? "red" : "blue") << ") :";
-                        for (auto v: ver_stack) {
-                            cout << v << " ";
-                        } //endfor
-                        cout << endl;
-                        cout << "Covering tree vertices (" << (face_color ? "red" : "blue") << ") :";
-                        for (auto v: ver_choice) {
-                            cout << v << " ";
-                        } //endfor
-                        cout << endl;
-                    }
-                }
-                else {
-                    #pragma omp critical
-                    {
-                        cout << "Could not find a-trail without crossing staples on branch " << i << endl;
-                    }
-                    break;
-                }
-            }
-
+                cout << (has_crossing_staples ? "A-trail has crossing staples." : "A-trail has no crossing staples.") << endl;
+            } //endfor
         } //endfor
-    } //endif
-#else
-    if (!checkPointGiven) { // Covering tree search from beginning
-        // User chooses which color face to search first
-        cout << "Input 1 (red) or 0 (blue)";
-        cin >> first_color;
-        while (first_color != 1 && first_color != 0) {
-            cout << "Input 1 (red) or 0 (blue)";
-            cin >> first_color;
-        } //endwhile
+        cout << "FINISHED" << endl;
+        cout << string(50, '=') << endl;
 
-        vector<int> ver_choice;
-        int color = first_color;
-        start = chrono::high_resolution_clock::now();
+        if (routed) {
+            return 0;
+        } //endif
+    } //endif
 
-        // First face color search
-        bool has_covering_tree = bb_covering_tree(eg, -1, 1, ver_stack, first_color, v_order,
-                                                      iterationCount, start, 0, shape, useCheckPoints);
+    // Covering tree search as CNF, solved by an external SAT solver if one is given
+    if (exportCNF && !checkPointGiven) {
+        cout << string(50, '=') << endl;
+        cout << "Writing covering tree search for each face color as CNF (DIMACS format) ..." << endl;
+        bool routed = false;
+        for (int color = 0; color < 2 && !routed; ++color) {
+            string cnf_file = "covering_tree_" + shape + (color ? "_red" : "_blue") + ".cnf";
+            ver_stack.clear();
+            if (!cnf_covering_tree(instances[color], cnf_file, solverCmd, ver_stack)) {
+                continue;
+            } //endif
 
-        // Search second face color
-        if (!has_covering_tree) {
-            has_covering_tree = bb_covering_tree(eg, -1, 1, ver_stack, (first_color + 1) % 2, v_order,
-                                                     iterationCount, start, 0, shape, useCheckPoints);
-            if (has_covering_tree) color = (first_color + 1) % 2;
             // Covering tree vertices
-            for (int j = 0; j < ver_stack.size(); ++j) {
-                ver_choice.push_back(v_order[ver_stack[j]]);
-            } //endfor
+            vector<int> ver_choice;
+            map_to_original(instances[color], ver_stack, ver_choice);
 
             // A-trail
-            if (!ver_choice.empty()) {
-                find_ATrail(eg, a_trail, ver_choice, first_color, shape + "_0");
-                bool has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                write_atrail_to_file(a_trail, first_color, shape + "_0", has_crossing_staples);
-            } //endfor
-        } else {
-            // Covering tree vertices
-            for (int j = 0; j < ver_stack.size(); ++j) {
-                ver_choice.push_back(v_order[ver_stack[j]]);
+            a_trail.clear();
+            find_ATrail(eg, a_trail, ver_choice, color, shape + "_sat");
+            bool has_crossing_staples = check_crossing_staples(adjL, a_trail);
+            write_atrail_to_file(a_trail, color, shape + "_sat", has_crossing_staples);
+            routed = !has_crossing_staples;
+
+            // Output covering tree vertices to console
+            cout << endl;
+            cout << "Covering tree found by SAT solver ..." << endl;
+            cout << "Covering tree vertices (" << (color ? "red" : "blue") << "): ";
+            for (auto v: ver_choice) {
+                cout << v << " ";
             } //endfor
+            cout << endl;
+            cout << (has_crossing_staples ? "A-trail has crossing staples." : "A-trail has no crossing staples.") << endl;
+        } //endfor
+        cout << "FINISHED" << endl;
+        cout << string(50, '=') << endl;
 
-            // A-trail
-            if (!ver_choice.empty()) {
-                find_ATrail(eg, a_trail, ver_choice, (first_color + 1) % 2, shape + "_1");
-                bool has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                write_atrail_to_file(a_trail, (first_color + 1) % 2, shape + "_1", has_crossing_staples);
-            } //endif
+        if (routed || solverCmd.empty()) {
+            return 0;
         } //endif
+    } //endif
 
-        // Output vertex stack and covering tree vertices to console
-        cout << endl;
-        cout << "Covering tree found ..." << endl;
-        cout << "Vertex stack (" << (color ? "red" : "blue") << ") :";
-        for (auto v: ver_stack) {
-            cout << v << " ";
-        } //endfor
-        cout << endl;
-        cout << "Covering tree vertices (" << (color ? "red" : "blue") << ") :";
-        for (auto v: ver_choice) {
-            cout << v << " ";
+    // Covering tree search
+    cout << string(50, '=') << endl;
+    cout << "Beginning covering tree search ..." << endl;
+
+    bool parallel = branches > 1; // Whether or not branches search in parallel (OpenMP threads or std::jthread workers)
+    set_engine_threads(branches);
+    if (!checkPointGiven && !parallel && shard < 0 && coordinatorAddress.empty() && workerAddress.empty()) { // Serial search from beginning
+        // Color with smaller estimated search first
+        first_color = estimates[1] < estimates[0];
+        cout << "Searching " << (first_color ? "red" : "blue") << " faces first (smaller estimated search)." << endl;
+
+        // First face color search (branch 1), then second face color search (branch 0)
+        Search_Pool pool(1, options.solutions, options.stop_first);
+        if (useCheckPoints) {
+            string checkpoint = checkpoint_file(shape, newest_checkpoint(shape) + 1);
+            pool.keepCheckpoints(checkpoint);
+            cout << "Checkpoints written to " << checkpoint << "." << endl;
+        } //endif
+        Trail_Pipeline trails(eg, adjL, instances, pool, 1);
+        bool has_covering_tree = false;
+        for (int branchNum = 1; branchNum >= 0 && !has_covering_tree; --branchNum) {
+            int color = branchNum ? first_color : (first_color + 1) % 2;
+            ver_stack.clear();
+            iterationCount = 0;
+            unsigned long long int prunedCount = 0;
+            start = chrono::high_resolution_clock::now();
+            Search_Task task = search_task(instances[color], -1, 0, ver_stack);
+            has_covering_tree = route_covering_trees(instances[color], options, crossing[color], task, ver_stack,
+                                                     iterationCount, prunedCount, start, branchNum, shape + "_" + to_string(branchNum), shape, useCheckPoints, pool, trails);
+            vector<Search_Task> none; // Nothing of the color left to checkpoint
+            pool.report(branchNum, none);
+            cout << "Branch " << branchNum << ": " << iterationCount << " search nodes, " << prunedCount << " decisions pruned as closing a cycle." << endl;
         } //endfor
-        // cout << endl;
+        trails.close();
+        if (!has_covering_tree) {
+            cout << "No covering tree found." << endl;
+        }
+        else if (!trails.isRouted(0) && !trails.isRouted(1)) {
+            cout << "Could not find a-trail without crossing staples." << endl;
+        } //endif
     }
-    else if (checkPointGiven) { // Start search from checkpoint file(s)
-        // Loop through given checkpoint files
-        for (int i = 0; i < checkpoints.size(); ++i) {
-            string line, n;
-            ifstream myFile;
-            myFile.open(checkpoints[i]);
-
-            int v, choice, face_color, branchNum;
-
-            // Read checkpoint file
-            if (myFile.is_open()) {
-                if (getline(myFile, line)) {
-                    istringstream stream(line);
-                    while (stream >> n) {
-                        if (n == "|") {
-                            break;
-                        } //endif
-                        ver_stack.push_back(stoi(n));
-                    } //endwhile
-                    stream >> n;
-                    v = stoi(n);
-                    stream >> n;
-                    choice = stoi(n);
-                    stream >> n;
-                    face_color = stoi(n);
-                    stream >> n;
-                    branchNum = stoi(n);
+    else { // Parallel search from beginning (or of one shard), resumed from checkpoint file(s) on any number of branches, or distributed
+        // Threads for engines searching a whole color (not branch-bound, or decided by dynamic programming),
+        // in proportion to the estimated search of each color
+        vector<long double> work(2);
+        vector<bool> splittable(2); // Whether or not each color is searched by the branch-bound search, split into subtrees
+        for (int color = 0; color < 2; ++color) {
+            bool decided = instances[color].infeasible || crossing[color] || (widths[color] <= TD_MAX_WIDTH && options.engine == "bb");
+            work[color] = decided ? 1 : estimates[color];
+            splittable[color] = options.engine == "bb" && !decided;
+        } //endfor
+        vector<int> color_branches(2);
+        color_branches[0] = (int)llround(branches * work[0] / (work[0] + work[1]));
+        color_branches[0] = min(max(color_branches[0], 1), max(branches - 1, 1));
+        color_branches[1] = max(branches - color_branches[0], 1);
+
+        // Open subtrees to start from; idle branches take subtrees split off busy ones (work stealing)
+        vector<Search_Task> tasks;
+        if (workerAddress.empty()) { // Workers take their subtrees from the coordinator instead
+            if (checkPointGiven) { // Every line of every checkpoint file is an open subtree, whichever branch wrote it
+                read_checkpoint_tasks(instances, checkpoints, tasks);
+                cout << "Resuming " << tasks.size() << " open subtree(s) from " << checkpoints.size() << " checkpoint file(s)"
+                     << (coordinatorAddress.empty() ? " with " + to_string(branches) + " branches sharing them." : ".") << endl;
+            }
+            else if (shard >= 0) { // Open subtrees dealt out to this shard, the same in every process
+                tasks = shard_tasks(instances, splittable, shard, shards);
+                cout << "Searching shard " << shard << " of " << shards << " (" << tasks.size() << " open subtree(s)) with " << branches << " branches sharing them." << endl;
+            }
+            else if (!coordinatorAddress.empty()) { // Open subtrees in depth-first order, for the first workers to take
+                tasks = shard_tasks(instances, splittable, 0, 1);
+            }
+            else { // Both colors start as one open subtree each
+                for (int color = 0; color < 2; ++color) {
+                    vector<int> empty;
+                    tasks.push_back(search_task(instances[color], -1, 0, empty));
+                } //endfor
+                cout << "Searching both face colors with " << branches << " branches sharing open subtrees." << endl;
+            } //endif
+        } //endif
+
+        // Branches searching the open subtrees of a pool, with output files named after the given name
+#ifdef USE_OPENMP
+        omp_set_max_active_levels(2); // Engines searching a whole color may use threads of idle branches
+#endif
+        vector<int> cores = available_cores();
+        auto search_branches = [&](Search_Pool& pool, Trail_Pipeline& trails, string name_shape) {
+            atomic<unsigned long long int> nodes = 0; // Search nodes of all branches
+            parallel_branches(branches, [&](int i) {
+                // Pinned branches search their own copy of the instances, first touched on their core
+                vector<Covering_Instance> replica;
+                if (options.pin_threads) {
+                    pin_branch(i, cores);
+                    replica = instances;
                 } //endif
+                vector<Covering_Instance>& local = options.pin_threads ? replica : instances;
+
+                vector<int> ver_stack;
+                unsigned long long int iterationCount = 0;
+                unsigned long long int prunedCount = 0; // Decisions pruned as closing a cycle in every subtree taken
+                std::chrono::time_point<std::chrono::high_resolution_clock> start;
+                chrono::nanoseconds busy(0); // Time spent searching (not waiting for subtrees)
+                int taken = 0;
+                Search_Task task;
+                while (pool.pop(task, i)) {
+                    int color = task.color;
+                    set_engine_threads(color_branches[color]);
+                    string name = name_shape + "_" + to_string(i) + (taken ? "_t" + to_string(taken) : "");
+                    ++taken;
+                    start = chrono::high_resolution_clock::now();
+                    auto begin = start;
+                    route_covering_trees(local[color], options, crossing[color], task, ver_stack,
+                                         iterationCount, prunedCount, start, i, name, name_shape, useCheckPoints, pool, trails);
+                    busy += chrono::high_resolution_clock::now() - begin;
+                } //endwhile
+
+                // Search rate of the branch
+                nodes += iterationCount;
+                double seconds = chrono::duration<double>(busy).count();
+                {
+                    lock_guard<mutex> guard(console_lock);
+                    cout << "Branch " << i << ": " << iterationCount << " search nodes in " << taken << " subtree(s), " << seconds << "s searching"
+                         << (seconds > 0 ? " (" + to_string((unsigned long long int)(iterationCount / seconds)) + " nodes/s)" : "")
+                         << ", " << prunedCount << " decisions pruned as closing a cycle." << endl;
+                }
+            });
+            return nodes.load();
+        };
+
+        if (!coordinatorAddress.empty()) { // Hands subtrees out to worker processes, searching none itself
+            int status = run_coordinator(coordinatorAddress, instances, tasks, options, shape, useCheckPoints);
+            if (status) {
+                return status;
+            } //endif
+        }
+        else if (!workerAddress.empty()) { // Searches subtrees handed out by the coordinator
+            int status = run_worker(workerAddress, instances, eg, adjL, options, branches, shape, search_branches);
+            if (status) {
+                return status;
             } //endif
-            myFile.close();
+        }
+        else {
+            Search_Pool pool(branches, options.solutions, options.stop_first);
+            for (auto& task : tasks) {
+                pool.push(task);
+            } //endfor
+            if (useCheckPoints) { // One file of every open subtree, queued or searched
+                string checkpoint = checkpoint_file(shape, newest_checkpoint(shape) + 1);
+                pool.keepCheckpoints(checkpoint);
+                cout << "Checkpoints written to " << checkpoint << "." << endl;
+            } //endif
+            Trail_Pipeline trails(eg, adjL, instances, pool, branches / BRANCHES_PER_TRAIL_WORKER);
 
-            start = chrono::high_resolution_clock::now();
-            bool has_covering_tree = bb_covering_tree(eg, v, choice, ver_stack, face_color, v_order,
-                                                          iterationCount, start, branchNum, shape, useCheckPoints);
+            // Searching for covering tree (parallelized)
+            unsigned long long int nodes = search_branches(pool, trails, shape);
+            trails.close();
 
-            // Covering tree vertices
-            vector<int> ver_choice;
-            for (int j = 0; j < ver_stack.size(); ++j) {
-                ver_choice.push_back(v_order[ver_stack[j]]);
+            for (int color = 0; color < 2; ++color) {
+                if (!trails.isRouted(color) && options.stop_first && trails.isRouted((color + 1) % 2)) {
+                    cout << (color ? "Red" : "Blue") << " search stopped at the first A-trail without crossing staples." << endl;
+                }
+                else if (!trails.isRouted(color)) {
+                    cout << "No " << (color ? "red" : "blue") << " A-trail without crossing staples found." << endl;
+                } //endif
             } //endfor
 
-            // A-trail
-            if (!ver_choice.empty()) {
-                find_ATrail(eg, a_trail, ver_choice, face_color, shape + "_" + to_string(branchNum));
-                bool has_crossing_staples = check_crossing_staples(adjL, a_trail);
-                write_atrail_to_file(a_trail, face_color, shape + "_" + to_string(branchNum), has_crossing_staples);
+            // Result of the shard, merged with those of the other shards by ./ERDOS --merge
+            if (shard >= 0) {
+                write_shard_result(search_shape, shard, shards, trails, nodes);
+                cout << "Shard result written to " << shard_result_file(search_shape, shard, shards) << "." << endl;
             } //endif
-
-            // Output vertex stack and covering tree vertices to console
-            #pragma omp critical
-            {
-                cout << endl;
-                cout << "Covering tree found ..." << endl;
-                cout << "Vertex stack (" << (face_color ? "red" : "blue") << ") branch " << i << ": ";
-                for (auto v: ver_stack) {
-                    cout << v << " ";
-                } //endfor
-                cout << endl;
-                cout << "Covering tree vertices (" << (face_color ? "red" : "blue") << ") branch " << i << ": ";
-                for (auto v: ver_choice) {
-                    cout << v << " ";
-                } //endfor
-                cout << endl;
-            }
-        } //endfor
+        } //endif
     } //endif
-#endif
 
     cout << "FINISHED" << endl;
     cout << string(50, '=') << endl;
@@ -0,0 +1,123 @@
+#include <vector>
+#include <string>
+#include <random>
+#include <algorithm>
+#include <numeric>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "estimate_covering_tree.h"
+
+using namespace std;
+
+const long double ESTIMATE_MARGIN = 2; // Factor by which another ordering must beat BFS ordering to replace it
+
+/*
+ * Estimates the number of branch-bound search nodes below a vertex stack by Knuth's random probes: each probe
+ * follows random "Yes"/"No" choices down to a leaf, weighting every node on its path by the product of the
+ * branching factors above it. Symmetry pruning is not modeled, so the estimate is of a somewhat larger tree.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param v Last branching vertex decided (-1 if none)
+ * @param ver_stack Covering tree vertices chosen up to v
+ * @param probes Number of probes to average
+ * @param seed Random seed
+ * @return long double Estimated number of search nodes (1 if the stack is already decided)
+ */
+long double estimate_search_size(Covering_Instance& instance, int v, vector<int>& ver_stack, int probes, unsigned int seed) {
+    int vertex_count = instance.vertices.size();
+    if (instance.infeasible) {
+        return 1;
+    } //endif
+    Face_Forest forest(instance.face_count, instance.covered_faces);
+    vector<int> forbidden(vertex_count, 0);
+    for (auto i : ver_stack) {
+        if (!forest.canAdd(instance.vertex_faces[i])) return 1;
+        forest.add(instance.vertex_faces[i]);
+        for (auto u : instance.conflicts[i]) ++forbidden[u];
+    } //endfor
+
+    mt19937 rng(seed);
+    long double total = 0;
+    vector<int> added;
+    for (int probe = 0; probe < probes; ++probe) {
+        long double weight = 1;
+        long double size = 1;
+        for (int next_v = v + 1; next_v < vertex_count && !forest.isTree(); ++next_v) {
+            if (!forbidden[next_v] && forest.canAdd(instance.vertex_faces[next_v])) {
+                weight *= 2;
+                if (rng() & 1) {
+                    forest.add(instance.vertex_faces[next_v]);
+                    for (auto u : instance.conflicts[next_v]) ++forbidden[u];
+                    added.push_back(next_v);
+                } //endif
+            } //endif
+            size += weight;
+        } //endfor
+        total += size;
+
+        while (!added.empty()) {
+            forest.undo();
+            for (auto u : instance.conflicts[added.back()]) --forbidden[u];
+            added.pop_back();
+        } //endwhile
+    } //endfor
+    return total / probes;
+}
+
+/*
+ * Picks the branching order of an instance with the smallest estimated search: BFS order (as reduced),
+ * vertices at faces with fewest vertices first, or vertices with most faces first. Another order replaces
+ * BFS order only if clearly smaller, and estimates use a fixed seed, so the choice is the same on every run
+ * (as checkpoint files require).
+ *
+ * @param instance Reduced covering tree search instance (reordered)
+ * @param probes Number of probes for each estimate
+ * @param ordering Name of the chosen order
+ * @return long double Estimated number of search nodes with the chosen order
+ */
+long double order_covering_tree(Covering_Instance& instance, int probes, string& ordering) {
+    int vertex_count = instance.vertices.size();
+    vector<int> empty;
+    ordering = "BFS";
+    long double best = estimate_search_size(instance, -1, empty, probes, 0);
+    if (instance.infeasible || vertex_count == 0) {
+        return best;
+    } //endif
+
+    // Candidate orders, stable so that BFS order breaks ties
+    vector<int> face_degree(instance.face_count, 0);
+    for (auto& faces : instance.vertex_faces) {
+        for (auto f : faces) ++face_degree[f];
+    } //endfor
+    vector<int> rarest(vertex_count);
+    for (int i = 0; i < vertex_count; ++i) {
+        rarest[i] = instance.face_count;
+        for (auto f : instance.vertex_faces[i]) rarest[i] = min(rarest[i], face_degree[f]);
+    } //endfor
+    vector<int> by_rarest(vertex_count);
+    iota(by_rarest.begin(), by_rarest.end(), 0);
+    stable_sort(by_rarest.begin(), by_rarest.end(), [&rarest](int a, int b) { return rarest[a] < rarest[b]; });
+    vector<int> by_faces(vertex_count);
+    iota(by_faces.begin(), by_faces.end(), 0);
+    stable_sort(by_faces.begin(), by_faces.end(), [&instance](int a, int b) { return instance.vertex_faces[a].size() > instance.vertex_faces[b].size(); });
+    vector<pair<string, vector<int>>> candidates = {{"rarest faces first", by_rarest}, {"most faces first", by_faces}};
+
+    vector<int> best_order;
+    long double bfs = best;
+    for (auto& [name, order] : candidates) {
+        Covering_Instance reordered = instance;
+        reorder_instance(reordered, order);
+        long double estimate = estimate_search_size(reordered, -1, empty, probes, 0);
+        if (estimate * ESTIMATE_MARGIN < bfs && estimate < best) {
+            best = estimate;
+            best_order = order;
+            ordering = name;
+        } //endif
+    } //endfor
+    if (!best_order.empty()) {
+        reorder_instance(instance, best_order);
+    } //endif
+    return best;
+}
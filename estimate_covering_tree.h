@@ -0,0 +1,14 @@
+#ifndef RATS_ESTIMATE_COVERING_TREE_H
+#define RATS_ESTIMATE_COVERING_TREE_H
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+const int ESTIMATE_PROBES = 1000; // Random probes averaged by each search size estimate
+
+long double estimate_search_size(Covering_Instance& instance, int v, vector<int>& ver_stack, int probes, unsigned int seed);
+long double order_covering_tree(Covering_Instance& instance, int probes, string& ordering);
+
+#endif //RATS_ESTIMATE_COVERING_TREE_H
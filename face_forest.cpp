@@ -0,0 +1,115 @@
+#include <vector>
+#include <algorithm>
+
+#include "face_forest.h"
+
+using namespace std;
+
+/*
+ * Default constructor
+ */
+Face_Forest::Face_Forest() : Face_Forest(0) {}
+
+/*
+ * Constructor
+ *
+ * @param face_count Number of colored faces
+ * @param covered_faces Faces covered before any vertex is added
+ */
+Face_Forest::Face_Forest(int face_count, const vector<int>& covered_faces) {
+    parent = vector<int>(face_count);
+    for (int i = 0; i < face_count; ++i) {
+        parent[i] = i;
+    } //endfor
+    size = vector<int>(face_count, 1);
+    cover = vector<int>(face_count, 0);
+    components = face_count;
+    uncovered = face_count;
+    for (auto f : covered_faces) {
+        if (cover[f]++ == 0) {
+            --uncovered;
+        } //endif
+    } //endfor
+}
+
+/*
+ * Finds representative face of the component containing a face
+ *
+ * @param f Face to search from
+ * @return int Representative face
+ */
+int Face_Forest::find(int f) const {
+    while (parent[f] != f) {
+        f = parent[f];
+    } //endwhile
+    return f;
+}
+
+/*
+ * Checks whether a vertex touching the given faces can join the forest without closing a cycle
+ *
+ * @param faces Colored faces of vertex
+ * @return bool Whether or not the faces all lie in different components
+ */
+bool Face_Forest::canAdd(const vector<int>& faces) const {
+    if (faces.empty()) {
+        return false; // Vertex would be isolated in covering tree
+    } //endif
+    for (int i = 0; i < faces.size(); ++i) {
+        int r = find(faces[i]);
+        for (int j = 0; j < i; ++j) {
+            if (find(faces[j]) == r) {
+                return false;
+            } //endif
+        } //endfor
+    } //endfor
+    return true;
+}
+
+/*
+ * Adds a vertex touching the given faces to the forest (assumes canAdd)
+ *
+ * @param faces Colored faces of vertex
+ */
+void Face_Forest::add(const vector<int>& faces) {
+    union_marks.push_back(union_log.size());
+    face_marks.push_back(face_log.size());
+    for (auto f : faces) {
+        if (cover[f]++ == 0) {
+            --uncovered;
+        } //endif
+        face_log.push_back(f);
+    } //endfor
+    for (int i = 1; i < faces.size(); ++i) {
+        int a = find(faces[0]);
+        int b = find(faces[i]);
+        if (size[a] < size[b]) {
+            swap(a, b);
+        } //endif
+        parent[b] = a;
+        size[a] += size[b];
+        --components;
+        union_log.push_back(b);
+    } //endfor
+}
+
+/*
+ * Removes the most recently added vertex from the forest
+ */
+void Face_Forest::undo() {
+    while (union_log.size() > union_marks.back()) {
+        int b = union_log.back();
+        union_log.pop_back();
+        size[parent[b]] -= size[b];
+        parent[b] = b;
+        ++components;
+    } //endwhile
+    union_marks.pop_back();
+    while (face_log.size() > face_marks.back()) {
+        if (--cover[face_log.back()] == 0) {
+            ++uncovered;
+        } //endif
+        face_log.pop_back();
+    } //endwhile
+    face_marks.pop_back();
+}
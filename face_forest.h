@@ -0,0 +1,38 @@
+#ifndef RATS_FACE_FOREST_H
+#define RATS_FACE_FOREST_H
+
+#include <vector>
+
+using namespace std;
+
+/*
+ * Class to represent the forest formed by covering tree vertices over the colored faces they touch.
+ * Faces are joined by union-find (without path compression) so that vertices can be removed again in
+ * reverse order of addition.
+ */
+class Face_Forest {
+private:
+    vector<int> parent;
+    vector<int> size;
+    vector<int> cover;
+    int components;
+    int uncovered;
+    vector<int> union_log;
+    vector<int> union_marks;
+    vector<int> face_log;
+    vector<int> face_marks;
+
+public:
+    Face_Forest();
+    Face_Forest(int face_count, const vector<int>& covered_faces = {});
+    int find(int f) const;
+    bool canAdd(const vector<int>& faces) const;
+    void add(const vector<int>& faces);
+    void undo();
+    bool isTree() const { return components == 1 && uncovered == 0; }
+    int getComponents() const { return components; }
+    int getUncovered() const { return uncovered; }
+    bool isCovered(int f) const { return cover[f] > 0; }
+};
+
+#endif //RATS_FACE_FOREST_H
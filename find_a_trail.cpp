@@ -192,4 +192,23 @@ void find_ATrail(CC_Embedded_Graph& eg, vector<Edge>& a_trail, vector<int>& ver_
             } //endif
         } //endif
     } //endwhile
-}
\ No newline at end of file
+}
+/*
+ * Checks whether every A-trail built on a covering tree of the given color has crossing staples. The A-trail
+ * traverses each edge along the orientation of its face of that color, whichever vertices are in the covering
+ * tree, so the in-out pattern around each vertex is known before any covering tree is searched.
+ *
+ * @param eg Embedded graph
+ * @param adjL Vertex-to-edge adjacency list
+ * @param color Color of covering tree
+ * @return bool Whether or not A-trails of every covering tree of the color have crossing staples
+ */
+bool forced_crossing_staples(CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, int color) {
+    vector<Edge> oriented;
+    for (auto& f : (color ? eg.getRedFaces() : eg.getBlueFaces())) {
+        for (auto& e : f.getEdges()) {
+            oriented.push_back(e);
+        } //endfor
+    } //endfor
+    return check_crossing_staples(adjL, oriented);
+}
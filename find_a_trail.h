@@ -7,6 +7,8 @@ void find_ATrail(CC_Embedded_Graph& eg, vector<Edge>& a_trail, vector<int>& ver_
 
 bool check_crossing_staples(map<int, vector<int>>& adjL, vector<Edge>& a_trail);
 
+bool forced_crossing_staples(CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, int color);
+
 void write_atrail_to_file(vector<Edge>& a_trail, int color, string shape, bool crossing_staples);
 
 #endif //RATS_FIND_A_TRAIL_H
@@ -0,0 +1,225 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "growth_covering_tree.h"
+
+using namespace std;
+
+const int INTERVAL = 1000000000;
+
+/*
+ * Growth search state: the partial covering tree is a single connected structure of colored faces
+ * grown from a root face. A vertex is dead once it is excluded or has two faces in the tree (adding
+ * it would close a cycle); a face outside the tree is starved once all of its vertices are dead.
+ */
+struct Growth_State {
+    vector<vector<int>> face_vertices;  // Branching vertices of each colored face
+    vector<bool> in_tree;               // Whether or not each face is joined to the tree
+    vector<int> tree_count;             // Faces of each vertex in the tree
+    vector<int> excluded;               // Whether or not each vertex was excluded ("No" branches)
+    vector<int> alive;                  // Vertices of each face that are not dead
+    int left;                           // Faces not in the tree
+    int starved;                        // Faces not in the tree without vertices that are not dead
+};
+
+/*
+ * Whether or not a vertex can no longer be added to the tree
+ *
+ * @param state Growth search state
+ * @param w Branching vertex
+ * @return bool Whether or not vertex is dead
+ */
+bool growth_dead(Growth_State& state, int w) {
+    return state.excluded[w] > 0 || state.tree_count[w] >= 2;
+}
+
+/*
+ * Updates live vertex counts of faces after a vertex dies or revives
+ *
+ * @param instance Reduced covering tree search instance
+ * @param state Growth search state
+ * @param w Branching vertex
+ * @param was_dead Whether or not vertex was dead before last change
+ */
+void growth_update(Covering_Instance& instance, Growth_State& state, int w, bool was_dead) {
+    bool now_dead = growth_dead(state, w);
+    if (was_dead == now_dead) return;
+    for (auto g : instance.vertex_faces[w]) {
+        if (now_dead) {
+            if (--state.alive[g] == 0 && !state.in_tree[g]) ++state.starved;
+        }
+        else {
+            if (state.alive[g]++ == 0 && !state.in_tree[g]) --state.starved;
+        } //endif
+    } //endfor
+}
+
+/*
+ * Joins colored face to the tree, or removes it again
+ *
+ * @param instance Reduced covering tree search instance
+ * @param state Growth search state
+ * @param f Colored face
+ * @param join Whether to join (true) or remove (false) face
+ */
+void growth_face(Covering_Instance& instance, Growth_State& state, int f, bool join) {
+    if (join) {
+        state.in_tree[f] = true;
+        --state.left;
+        if (state.alive[f] == 0) --state.starved;
+    } //endif
+    for (auto w : state.face_vertices[f]) {
+        bool was_dead = growth_dead(state, w);
+        state.tree_count[w] += join ? 1 : -1;
+        growth_update(instance, state, w, was_dead);
+    } //endfor
+    if (!join) {
+        state.in_tree[f] = false;
+        ++state.left;
+        if (state.alive[f] == 0) ++state.starved;
+    } //endif
+}
+
+/*
+ * Excludes vertex from the tree, or allows it again
+ *
+ * @param instance Reduced covering tree search instance
+ * @param state Growth search state
+ * @param w Branching vertex
+ * @param exclude Whether to exclude (true) or allow (false) vertex
+ */
+void growth_exclude(Covering_Instance& instance, Growth_State& state, int w, bool exclude) {
+    bool was_dead = growth_dead(state, w);
+    state.excluded[w] += exclude ? 1 : -1;
+    growth_update(instance, state, w, was_dead);
+}
+
+/*
+ * Recursive helper of growth search. Branches "Yes" or "No" on a frontier vertex (exactly one face in the
+ * tree, so adding it never closes a cycle), choosing one that reaches the face with fewest live vertices.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param state Growth search state
+ * @param ver_stack Covering tree vertices (branching vertices of instance)
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return bool Facilitates  branch-bound decision-making.
+ */
+bool growth_covering_tree_util(Covering_Instance& instance, Growth_State& state, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    // Time
+    ++iterationCount;
+    if (iterationCount % INTERVAL == 0) {
+        auto end = chrono::high_resolution_clock::now();
+        auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
+        {
+            lock_guard<mutex> guard(console_lock);
+            cout << branchNum << "-" << iterationCount << ": " << time.count() << "ms (growth, " << state.left << " faces left)" << endl;
+        }
+        start = chrono::high_resolution_clock::now();
+    } //endif
+
+    if (state.left == 0) {
+        return true;
+    } //endif
+    if (state.starved > 0) {
+        return false;
+    } //endif
+
+    // Frontier vertex reaching the face with fewest live vertices
+    int next_v = -1;
+    int best = 0;
+    for (int w = 0; w < instance.vertices.size(); ++w) {
+        if (state.tree_count[w] != 1 || growth_dead(state, w)) continue;
+        int score = -1;
+        for (auto g : instance.vertex_faces[w]) {
+            if (!state.in_tree[g] && (score == -1 || state.alive[g] < score)) score = state.alive[g];
+        } //endfor
+        if (next_v == -1 || score < best) {
+            next_v = w;
+            best = score;
+        } //endif
+    } //endfor
+    if (next_v == -1) {
+        return false;
+    } //endif
+
+    // "Yes" to frontier vertex
+    vector<int> joined;
+    ver_stack.push_back(next_v);
+    for (auto g : instance.vertex_faces[next_v]) {
+        if (!state.in_tree[g]) {
+            growth_face(instance, state, g, true);
+            joined.push_back(g);
+        } //endif
+    } //endfor
+    if (growth_covering_tree_util(instance, state, ver_stack, iterationCount, start, branchNum)) {
+        return true;
+    } //endif
+    for (int k = joined.size() - 1; k >= 0; --k) {
+        growth_face(instance, state, joined[k], false);
+    } //endfor
+    ver_stack.pop_back();
+
+    // "No" to frontier vertex
+    growth_exclude(instance, state, next_v, true);
+    bool has_covering_tree = growth_covering_tree_util(instance, state, ver_stack, iterationCount, start, branchNum);
+    growth_exclude(instance, state, next_v, false);
+    return has_covering_tree;
+}
+
+/*
+ * Searches for a covering tree by growing it as one connected structure from a colored face (the one with
+ * fewest vertices), only ever branching on vertices at its frontier.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return bool Whether or not a covering tree exists
+ */
+bool growth_covering_tree(Covering_Instance& instance, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    int vertex_count = instance.vertices.size();
+    if (instance.infeasible) {
+        return false;
+    } //endif
+    if (instance.face_count <= 1) {
+        if (!instance.covered_faces.empty()) return true;
+        if (vertex_count == 0) return false;
+        ver_stack.push_back(0);
+        return true;
+    } //endif
+
+    Growth_State state;
+    state.face_vertices = vector<vector<int>>(instance.face_count);
+    for (int w = 0; w < vertex_count; ++w) {
+        for (auto g : instance.vertex_faces[w]) state.face_vertices[g].push_back(w);
+    } //endfor
+    state.in_tree = vector<bool>(instance.face_count, false);
+    state.tree_count = vector<int>(vertex_count, 0);
+    state.excluded = vector<int>(vertex_count, 0);
+    state.alive = vector<int>(instance.face_count, 0);
+    state.left = instance.face_count;
+    state.starved = 0;
+    int root = 0;
+    for (int f = 0; f < instance.face_count; ++f) {
+        state.alive[f] = state.face_vertices[f].size();
+        if (state.alive[f] == 0) ++state.starved;
+        if (state.alive[f] < state.alive[root]) root = f;
+    } //endfor
+    growth_face(instance, state, root, true);
+
+    ver_stack.clear();
+    bool has_covering_tree = growth_covering_tree_util(instance, state, ver_stack, iterationCount, start, branchNum);
+    sort(ver_stack.begin(), ver_stack.end()); // Stack in branching order, as from branch-bound search
+    return has_covering_tree;
+}
@@ -0,0 +1,253 @@
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+#include <numeric>
+
+#include "cc_embedded_graph.h"
+#include "kernelize.h"
+
+using namespace std;
+
+/*
+ * Reduces the covering tree search for one face color by applying safe rules until nothing changes:
+ * - vertices without colored faces, or whose faces are already joined (closing a cycle), are dropped
+ * - vertices with a single colored face are dropped (a covering tree stays one with or without them)
+ * - vertices with identical colored faces are merged into one equivalence class
+ * - a face with a single incident vertex forces that vertex in, contracting its faces into one
+ *
+ * @param eg Embedded graph
+ * @param face_color Face color to consider
+ * @param v_order BFS vertex ordering
+ * @param instance Reduced instance to be made
+ */
+void kernelize(CC_Embedded_Graph& eg, int face_color, vector<int>& v_order, Covering_Instance& instance) {
+    vector<vector<int>> face_vertices = face_color ? eg.getRedFaceV() : eg.getBlueFaceV();
+    int color_face_count = face_color ? eg.getRedFaces().size() : eg.getBlueFaces().size();
+    int n = v_order.size();
+
+    instance = Covering_Instance();
+    instance.face_color = face_color;
+
+    // Contracted faces
+    vector<int> parent(color_face_count);
+    iota(parent.begin(), parent.end(), 0);
+    auto find = [&parent](int f) {
+        while (parent[f] != f) {
+            f = parent[f] = parent[parent[f]];
+        } //endwhile
+        return f;
+    };
+    vector<bool> covered(color_face_count, false);
+    int face_count = color_face_count;
+
+    // Vertices by vertex ordering index
+    vector<bool> alive(n, true);
+    vector<vector<int>> members(n);
+    vector<vector<int>> faces(n);
+    for (int i = 0; i < n; ++i) {
+        members[i].push_back(v_order[i]);
+    } //endfor
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        // Drop or merge vertices based on their contracted faces
+        map<vector<int>, int> first_with_faces;
+        vector<int> incident(color_face_count, 0);
+        vector<int> only(color_face_count, -1);
+        for (int i = 0; i < n; ++i) {
+            if (!alive[i]) continue;
+            faces[i].clear();
+            for (auto f : face_vertices[v_order[i]]) {
+                faces[i].push_back(find(f));
+            } //endfor
+            sort(faces[i].begin(), faces[i].end());
+            bool closes_cycle = adjacent_find(faces[i].begin(), faces[i].end()) != faces[i].end();
+            if (closes_cycle || faces[i].empty() || (faces[i].size() == 1 && face_count > 1)) {
+                if (!closes_cycle && faces[i].size() == 1) {
+                    instance.leaves.insert(instance.leaves.end(), members[i].begin(), members[i].end());
+                } //endif
+                if (!closes_cycle) ++instance.dominated;
+                alive[i] = false;
+                changed = true;
+                continue;
+            } //endif
+            auto twin = first_with_faces.find(faces[i]);
+            if (twin != first_with_faces.end()) {
+                members[twin->second].insert(members[twin->second].end(), members[i].begin(), members[i].end());
+                ++instance.dominated;
+                alive[i] = false;
+                changed = true;
+                continue;
+            } //endif
+            first_with_faces[faces[i]] = i;
+            for (auto f : faces[i]) {
+                ++incident[f];
+                only[f] = i;
+            } //endfor
+        } //endfor
+        if (changed) continue;
+
+        // Faces that cannot be reached, or reached by a single vertex
+        if (face_count == 1) break;
+        for (int f = 0; f < color_face_count; ++f) {
+            if (parent[f] != f) continue;
+            if (incident[f] == 0) {
+                instance.infeasible = true;
+                break;
+            } //endif
+            if (incident[f] == 1) {
+                int u = only[f];
+                instance.forced.push_back(v_order[u]);
+                instance.forced_classes.push_back(members[u]);
+                alive[u] = false;
+                for (int j = 1; j < faces[u].size(); ++j) {
+                    parent[find(faces[u][j])] = find(faces[u][0]);
+                    --face_count;
+                } //endfor
+                covered[find(faces[u][0])] = true;
+                changed = true;
+                break;
+            } //endif
+        } //endfor
+        if (instance.infeasible) break;
+    } //endwhile
+
+    // A single face left must be covered by a forced or branching vertex
+    if (face_count == 1 && !covered[find(0)] && count(alive.begin(), alive.end(), true) == 0) {
+        instance.infeasible = true;
+    } //endif
+
+    // Renumber contracted faces
+    vector<int> face_id(color_face_count, -1);
+    for (int f = 0; f < color_face_count; ++f) {
+        if (parent[f] == f) {
+            face_id[f] = instance.face_count++;
+            if (covered[f]) instance.covered_faces.push_back(face_id[f]);
+        } //endif
+    } //endfor
+
+    // Branching vertices in vertex ordering
+    vector<int> reduced_index(eg.getVertexCount(), -1);
+    for (int i = 0; i < n; ++i) {
+        if (!alive[i]) continue;
+        vector<int> vf;
+        for (auto f : faces[i]) {
+            vf.push_back(face_id[f]);
+        } //endfor
+        sort(vf.begin(), vf.end());
+        for (auto u : members[i]) {
+            reduced_index[u] = instance.vertices.size();
+        } //endfor
+        instance.vertex_faces.push_back(vf);
+        instance.vertices.push_back(v_order[i]);
+        instance.classes.push_back(members[i]);
+    } //endfor
+    eg.calcConflicts(instance.vertex_faces, instance.conflicts);
+
+    // Automorphisms of mesh acting on branching vertices
+    vector<vector<int>> face_members(instance.face_count);
+    for (int i = 0; i < instance.vertex_faces.size(); ++i) {
+        for (auto f : instance.vertex_faces[i]) {
+            face_members[f].push_back(i);
+        } //endfor
+    } //endfor
+    set<pair<bool, vector<int>>> face_set;
+    vector<bool> face_covered(instance.face_count, false);
+    for (auto f : instance.covered_faces) face_covered[f] = true;
+    for (int f = 0; f < instance.face_count; ++f) {
+        face_set.insert({face_covered[f], face_members[f]});
+    } //endfor
+
+    vector<vector<int>> v_automorphisms = face_color ? eg.getRedAutomorphisms() : eg.getBlueAutomorphisms();
+    set<vector<int>> found;
+    for (auto& g : v_automorphisms) {
+        vector<int> perm(instance.vertices.size());
+        bool valid = true;
+        for (int i = 0; i < instance.vertices.size() && valid; ++i) {
+            perm[i] = reduced_index[g[instance.vertices[i]]];
+            valid = perm[i] != -1;
+        } //endfor
+        for (int f = 0; f < instance.face_count && valid; ++f) {
+            vector<int> image;
+            for (auto i : face_members[f]) image.push_back(perm[i]);
+            sort(image.begin(), image.end());
+            valid = face_set.count({face_covered[f], image}) > 0;
+        } //endfor
+        if (valid) found.insert(perm);
+    } //endfor
+    vector<int> identity(instance.vertices.size());
+    iota(identity.begin(), identity.end(), 0);
+    found.insert(identity);
+    instance.automorphisms = vector<vector<int>>(found.begin(), found.end());
+}
+
+/*
+ * Maps covering tree vertices of a reduced instance back to original vertices
+ *
+ * @param instance Reduced instance
+ * @param ver_stack Covering tree vertices of reduced instance
+ * @param ver_choice Original covering tree vertices (appended to)
+ */
+void map_to_original(Covering_Instance& instance, vector<int>& ver_stack, vector<int>& ver_choice) {
+    for (auto u : instance.forced) {
+        ver_choice.push_back(u);
+    } //endfor
+    for (auto i : ver_stack) {
+        ver_choice.push_back(instance.vertices[i]);
+    } //endfor
+}
+
+/*
+ * Lists the original vertices a covering tree of a reduced instance stands for: any one vertex of the class of
+ * each forced and chosen branching vertex, and each vertex with a single colored face or not (-1). Every
+ * combination of one entry of each list is a different covering tree of the original vertices.
+ *
+ * @param instance Reduced instance
+ * @param ver_stack Covering tree vertices of reduced instance
+ * @param choices Original vertices to choose one of, for each vertex of the covering tree (appended to)
+ */
+void original_choices(Covering_Instance& instance, vector<int>& ver_stack, vector<vector<int>>& choices) {
+    for (auto& members : instance.forced_classes) {
+        choices.push_back(members);
+    } //endfor
+    for (auto i : ver_stack) {
+        choices.push_back(instance.classes[i]);
+    } //endfor
+    for (auto u : instance.leaves) {
+        choices.push_back({-1, u});
+    } //endfor
+}
+
+/*
+ * Reorders branching vertices of a reduced instance (the order in which branch-bound search decides them)
+ *
+ * @param instance Reduced instance
+ * @param order Branching vertex to place at each position
+ */
+void reorder_instance(Covering_Instance& instance, vector<int>& order) {
+    int n = order.size();
+    vector<int> position(n);
+    for (int k = 0; k < n; ++k) {
+        position[order[k]] = k;
+    } //endfor
+
+    Covering_Instance reordered = instance;
+    for (int k = 0; k < n; ++k) {
+        int i = order[k];
+        reordered.vertex_faces[k] = instance.vertex_faces[i];
+        reordered.vertices[k] = instance.vertices[i];
+        reordered.classes[k] = instance.classes[i];
+        reordered.conflicts[k].clear();
+        for (auto u : instance.conflicts[i]) reordered.conflicts[k].push_back(position[u]);
+        sort(reordered.conflicts[k].begin(), reordered.conflicts[k].end());
+    } //endfor
+    for (int g = 0; g < instance.automorphisms.size(); ++g) {
+        for (int i = 0; i < n; ++i) {
+            reordered.automorphisms[g][position[i]] = position[instance.automorphisms[g][i]];
+        } //endfor
+    } //endfor
+    instance = reordered;
+}
@@ -0,0 +1,33 @@
+#ifndef RATS_KERNELIZE_H
+#define RATS_KERNELIZE_H
+
+#include <vector>
+
+using namespace std;
+
+/*
+ * Struct to represent a reduced covering tree search instance for one face color. Branching vertices are
+ * indexed in BFS vertex ordering; faces joined by forced vertices are contracted into one face.
+ */
+struct Covering_Instance {
+    int face_color = 0;
+    int face_count = 0;                 // Faces left after contraction
+    bool infeasible = false;            // Whether reduction proved no covering tree exists
+    vector<vector<int>> vertex_faces;   // Faces of each branching vertex
+    vector<int> covered_faces;          // Faces already covered by forced vertices
+    vector<int> vertices;               // Original vertex representing each branching vertex
+    vector<vector<int>> classes;        // Original vertices with identical faces as each branching vertex
+    vector<int> forced;                 // Original vertices in every covering tree
+    int dominated = 0;                  // Vertices dropped (no or a single colored face) or merged into a class by dominance
+    vector<vector<int>> forced_classes; // Original vertices with the faces of each forced vertex (any one of them will do)
+    vector<int> leaves;                 // Original vertices with a single colored face (in a covering tree or not alike)
+    vector<vector<int>> conflicts;      // Pairwise conflicts between branching vertices
+    vector<vector<int>> automorphisms;  // Color-preserving automorphisms acting on branching vertices
+};
+
+void kernelize(CC_Embedded_Graph& eg, int face_color, vector<int>& v_order, Covering_Instance& instance);
+void map_to_original(Covering_Instance& instance, vector<int>& ver_stack, vector<int>& ver_choice);
+void original_choices(Covering_Instance& instance, vector<int>& ver_stack, vector<vector<int>>& choices);
+void reorder_instance(Covering_Instance& instance, vector<int>& order);
+
+#endif //RATS_KERNELIZE_H
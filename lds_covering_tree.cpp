@@ -0,0 +1,146 @@
+#include <vector>
+#include <string>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "lds_covering_tree.h"
+
+using namespace std;
+
+const int INTERVAL = 1000000000;
+
+/*
+ * Greedy choice of next covering tree vertex: the one covering the most uncovered colored faces without
+ * closing a cycle, ties broken by the most components joined. Also checks whether every uncovered face
+ * can still be covered by some vertex that is not excluded.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param forest Colored faces joined by current covering tree vertices
+ * @param excluded Whether or not each vertex was excluded (discrepancies taken)
+ * @param reachable Whether or not each face has a candidate vertex (scratch space)
+ * @return int Greedy vertex (-1 if none, or if some uncovered face can no longer be covered)
+ */
+int lds_greedy(Covering_Instance& instance, Face_Forest& forest, vector<int>& excluded, vector<bool>& reachable) {
+    int best = -1;
+    int best_covered = -1;
+    int best_joined = -1;
+    fill(reachable.begin(), reachable.end(), false);
+    for (int w = 0; w < instance.vertices.size(); ++w) {
+        if (excluded[w] || !forest.canAdd(instance.vertex_faces[w])) continue;
+        int covered = 0;
+        for (auto f : instance.vertex_faces[w]) {
+            if (!forest.isCovered(f)) ++covered;
+            reachable[f] = true;
+        } //endfor
+        int joined = instance.vertex_faces[w].size() - 1;
+        if (covered > best_covered || (covered == best_covered && joined > best_joined)) {
+            best = w;
+            best_covered = covered;
+            best_joined = joined;
+        } //endif
+    } //endfor
+    for (int f = 0; f < instance.face_count; ++f) {
+        if (!forest.isCovered(f) && !reachable[f]) return -1;
+    } //endfor
+    return best;
+}
+
+/*
+ * Recursive helper of limited discrepancy search. Follows the greedy choice for free; excluding the greedy
+ * vertex instead is a discrepancy, allowed only while some of the budget is left.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param forest Colored faces joined by current covering tree vertices
+ * @param excluded Whether or not each vertex was excluded
+ * @param reachable Scratch space for greedy choice
+ * @param budget Discrepancies left
+ * @param cut Whether or not some discrepancy was refused for lack of budget
+ * @param ver_stack Covering tree vertices (branching vertices of instance)
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return bool Facilitates  branch-bound decision-making.
+ */
+bool lds_covering_tree_util(Covering_Instance& instance, Face_Forest& forest, vector<int>& excluded, vector<bool>& reachable, int budget, bool& cut, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    // Time
+    ++iterationCount;
+    if (iterationCount % INTERVAL == 0) {
+        auto end = chrono::high_resolution_clock::now();
+        auto time = chrono::duration_cast<chrono::milliseconds>(end - start);
+        {
+            lock_guard<mutex> guard(console_lock);
+            cout << branchNum << "-" << iterationCount << ": " << time.count() << "ms (limited discrepancy, " << budget << " discrepancies left)" << endl;
+        }
+        start = chrono::high_resolution_clock::now();
+    } //endif
+
+    if (forest.isTree()) {
+        return true;
+    } //endif
+    int next_v = lds_greedy(instance, forest, excluded, reachable);
+    if (next_v == -1) {
+        return false;
+    } //endif
+
+    // Greedy choice
+    ver_stack.push_back(next_v);
+    forest.add(instance.vertex_faces[next_v]);
+    if (lds_covering_tree_util(instance, forest, excluded, reachable, budget, cut, ver_stack, iterationCount, start, branchNum)) {
+        return true;
+    } //endif
+    forest.undo();
+    ver_stack.pop_back();
+
+    // Discrepancy
+    if (budget == 0) {
+        cut = true;
+        return false;
+    } //endif
+    excluded[next_v] = 1;
+    bool has_covering_tree = lds_covering_tree_util(instance, forest, excluded, reachable, budget - 1, cut, ver_stack, iterationCount, start, branchNum);
+    excluded[next_v] = 0;
+    return has_covering_tree;
+}
+
+/*
+ * Searches for a covering tree by limited discrepancy search around the greedy covering heuristic, allowing
+ * 0, 1, 2, ... deviations from it. Once no deviation is refused for lack of budget the search was complete.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param iterationCount Number of search nodes
+ * @param start Time of last progress output
+ * @param branchNum Parallel branch number
+ * @return bool Whether or not a covering tree exists
+ */
+bool lds_covering_tree(Covering_Instance& instance, vector<int>& ver_stack, unsigned long long int& iterationCount, std::chrono::time_point<std::chrono::high_resolution_clock>& start, int branchNum) {
+    if (instance.infeasible) {
+        return false;
+    } //endif
+
+    Face_Forest forest(instance.face_count, instance.covered_faces);
+    vector<int> excluded(instance.vertices.size(), 0);
+    vector<bool> reachable(instance.face_count);
+    bool has_covering_tree = false;
+    bool cut = true;
+    int budget = 0;
+    ver_stack.clear();
+    for (; cut && !has_covering_tree; ++budget) {
+        cut = false;
+        has_covering_tree = lds_covering_tree_util(instance, forest, excluded, reachable, budget, cut, ver_stack, iterationCount, start, branchNum);
+    } //endfor
+    sort(ver_stack.begin(), ver_stack.end()); // Stack in branching order, as from branch-bound search
+
+    {
+        lock_guard<mutex> guard(console_lock);
+        cout << "Branch " << branchNum << ": limited discrepancy search " << (has_covering_tree ? "found a covering tree" : "finished")
+             << " with at most " << budget - 1 << " discrepancies after " << iterationCount << " nodes" << endl;
+    }
+    return has_covering_tree;
+}
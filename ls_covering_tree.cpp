@@ -0,0 +1,232 @@
+#include <vector>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "ls_covering_tree.h"
+
+using namespace std;
+
+const double LS_START_TEMP = 2.0; // Temperature at start of each cooling round
+const double LS_END_TEMP = 0.05; // Temperature at end of each cooling round
+
+/*
+ * Finds root of colored face in union-find of faces joined by chosen vertices
+ *
+ * @param parent Union-find parents of faces
+ * @param f Colored face
+ * @return int Root of face
+ */
+int ls_find(vector<int>& parent, int f) {
+    while (parent[f] != f) {
+        parent[f] = parent[parent[f]];
+        f = parent[f];
+    } //endwhile
+    return f;
+}
+
+/*
+ * Rebuilds union-find of faces joined by chosen vertices
+ *
+ * @param instance Reduced covering tree search instance
+ * @param chosen Whether or not each branching vertex is chosen
+ * @param parent Union-find parents of faces to be rebuilt
+ * @return int Number of unions made (faces minus components)
+ */
+int ls_rebuild(Covering_Instance& instance, vector<char>& chosen, vector<int>& parent) {
+    for (int f = 0; f < parent.size(); ++f) parent[f] = f;
+    int merges = 0;
+    for (int v = 0; v < chosen.size(); ++v) {
+        if (!chosen[v]) continue;
+        int a = ls_find(parent, instance.vertex_faces[v][0]);
+        for (int k = 1; k < instance.vertex_faces[v].size(); ++k) {
+            int b = ls_find(parent, instance.vertex_faces[v][k]);
+            if (a != b) {
+                parent[b] = a;
+                ++merges;
+            } //endif
+        } //endfor
+    } //endfor
+    return merges;
+}
+
+/*
+ * Counts pieces the component of a chosen vertex splits into once it is removed, by searching from each of
+ * its faces through the other chosen vertices
+ *
+ * @param instance Reduced covering tree search instance
+ * @param face_vertices Branching vertices of each colored face
+ * @param chosen Whether or not each branching vertex is chosen
+ * @param v Chosen vertex to remove
+ * @param seen Search stamp of each face
+ * @param stamp Current search stamp
+ * @return int Number of pieces
+ */
+int ls_pieces(Covering_Instance& instance, vector<vector<int>>& face_vertices, vector<char>& chosen, int v, vector<int>& seen, int& stamp) {
+    vector<int>& faces = instance.vertex_faces[v];
+    int pieces = 0;
+    int reached = 0;
+    ++stamp;
+    for (auto f : faces) {
+        if (reached == faces.size()) break;
+        if (seen[f] == stamp) continue;
+        ++pieces;
+        vector<int> q = {f};
+        seen[f] = stamp;
+        ++reached;
+        while (!q.empty() && reached < faces.size()) {
+            int g = q.back();
+            q.pop_back();
+            for (auto u : face_vertices[g]) {
+                if (u == v || !chosen[u]) continue;
+                for (auto h : instance.vertex_faces[u]) {
+                    if (seen[h] == stamp) continue;
+                    seen[h] = stamp;
+                    q.push_back(h);
+                    if (find(faces.begin(), faces.end(), h) != faces.end()) ++reached;
+                } //endfor
+            } //endfor
+        } //endwhile
+    } //endfor
+    return pieces;
+}
+
+/*
+ * Single simulated annealing chain over sets of chosen vertices. The objective is the number of cycles plus
+ * the number of uncovered colored faces plus the number of extra components, which is zero exactly for
+ * covering trees. Flipping a vertex in is evaluated by union-find, flipping one out by searching its component.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param face_vertices Branching vertices of each colored face
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param rounds Cooling rounds tried before giving up
+ * @param seed Seed of chain
+ * @param solved Whether or not any chain has found a covering tree
+ * @return bool Whether or not chain found a covering tree
+ */
+bool ls_chain(Covering_Instance& instance, vector<vector<int>>& face_vertices, vector<int>& ver_stack, int rounds, unsigned int seed, atomic<bool>& solved) {
+    int vertex_count = instance.vertices.size();
+    int face_count = instance.face_count;
+    mt19937 rng(seed);
+    uniform_real_distribution<double> unit(0.0, 1.0);
+
+    vector<char> chosen(vertex_count, 0);
+    vector<int> touched(face_count, 0);
+    for (auto f : instance.covered_faces) ++touched[f];
+    vector<int> parent(face_count);
+    vector<int> seen(face_count, 0);
+    int stamp = 0;
+    int merges = ls_rebuild(instance, chosen, parent);
+    int uncovered = count(touched.begin(), touched.end(), 0);
+    long long int objective = uncovered + face_count - 1;
+
+    unsigned long long int round = max(1000ULL, 100ULL * vertex_count);
+    unsigned long long int max_flips = round * rounds; // Budget grows with the instance, so small ones give up quickly
+    for (unsigned long long int flip = 0; flip < max_flips && objective != 0; ++flip) {
+        if (flip % 1024 == 0 && solved) {
+            return false;
+        } //endif
+        if (vertex_count == 0) break;
+
+        double temp = LS_START_TEMP * pow(LS_END_TEMP / LS_START_TEMP, (double)(flip % round) / round);
+        int v = rng() % vertex_count;
+        vector<int>& faces = instance.vertex_faces[v];
+        int degree = faces.size();
+
+        long long int delta;
+        if (!chosen[v]) {
+            int newly_covered = 0;
+            vector<int> roots;
+            for (auto f : faces) {
+                if (touched[f] == 0) ++newly_covered;
+                int r = ls_find(parent, f);
+                if (find(roots.begin(), roots.end(), r) == roots.end()) roots.push_back(r);
+            } //endfor
+            delta = (degree - 1) - 2 * ((long long int)roots.size() - 1) - newly_covered;
+        }
+        else {
+            int newly_uncovered = 0;
+            for (auto f : faces) {
+                if (touched[f] == 1) ++newly_uncovered;
+            } //endfor
+            int pieces = ls_pieces(instance, face_vertices, chosen, v, seen, stamp);
+            delta = -(degree - 1) + 2 * (pieces - 1) + newly_uncovered;
+        } //endif
+        if (delta > 0 && unit(rng) >= exp(-delta / temp)) continue;
+
+        // Apply flip
+        objective += delta;
+        if (!chosen[v]) {
+            chosen[v] = 1;
+            for (auto f : faces) {
+                if (touched[f]++ == 0) --uncovered;
+            } //endfor
+            int a = ls_find(parent, faces[0]);
+            for (int k = 1; k < degree; ++k) {
+                int b = ls_find(parent, faces[k]);
+                if (a != b) {
+                    parent[b] = a;
+                    ++merges;
+                } //endif
+            } //endfor
+        }
+        else {
+            chosen[v] = 0;
+            for (auto f : faces) {
+                if (--touched[f] == 0) ++uncovered;
+            } //endfor
+            merges = ls_rebuild(instance, chosen, parent);
+        } //endif
+    } //endfor
+
+    if (objective != 0) {
+        return false;
+    } //endif
+    for (int v = 0; v < vertex_count; ++v) {
+        if (chosen[v]) ver_stack.push_back(v);
+    } //endfor
+    return true;
+}
+
+/*
+ * Searches for a covering tree by simulated annealing, with independent chains run as parallel branches. The search
+ * is incomplete: failing to find a covering tree does not mean none exists.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @param chains Number of independent chains
+ * @param rounds Cooling rounds tried by each chain before giving up
+ * @param seed Seed of search (chains are seeded after it)
+ * @return bool Whether or not a covering tree was found
+ */
+bool ls_covering_tree(Covering_Instance& instance, vector<int>& ver_stack, int chains, int rounds, unsigned int seed) {
+    if (instance.infeasible) {
+        return false;
+    } //endif
+
+    vector<vector<int>> face_vertices(instance.face_count);
+    for (int v = 0; v < instance.vertices.size(); ++v) {
+        for (auto f : instance.vertex_faces[v]) face_vertices[f].push_back(v);
+    } //endfor
+
+    atomic<bool> solved = false;
+    mutex lock; // Guards the covering tree of the first chain to find one
+    parallel_branches(chains, [&](int c) {
+        vector<int> chain_stack;
+        if (ls_chain(instance, face_vertices, chain_stack, rounds, seed * chains + c, solved)) {
+            lock_guard<mutex> guard(lock);
+            if (!solved) {
+                ver_stack = chain_stack;
+                solved = true;
+            } //endif
+        } //endif
+    });
+    return solved;
+}
@@ -0,0 +1,13 @@
+#ifndef RATS_LS_COVERING_TREE_H
+#define RATS_LS_COVERING_TREE_H
+
+#include <vector>
+
+using namespace std;
+
+const int LS_ROUNDS = 200; // Cooling rounds (about 100 flips per branching vertex each) tried by each chain before giving up
+const int LS_ATTEMPTS = 8; // Covering trees tried by local search before an A-trail without crossing staples is given up on
+
+bool ls_covering_tree(Covering_Instance& instance, vector<int>& ver_stack, int chains, int rounds, unsigned int seed);
+
+#endif //RATS_LS_COVERING_TREE_H
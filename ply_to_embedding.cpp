@@ -14,9 +14,10 @@ using namespace std;
  * @param file_name String representing the ply file to be read.
  * @param vertices Container to hold vertex information.
  * @param faces Container to hold face information.
+ * @param quiet Whether or not to leave out the vertex and face counts printed to console.
  * @return bool Whether or not file was successfully read.
  */
-bool ply_to_embedding(string file_name, vector<vector<double>>& vertices, vector<vector<int>>& faces) {
+bool ply_to_embedding(string file_name, vector<vector<double>>& vertices, vector<vector<int>>& faces, bool quiet) {
 
     string line;
     ifstream my_file;
@@ -49,13 +50,13 @@ bool ply_to_embedding(string file_name, vector<vector<double>>& vertices, vector
             // Checks vertex count
             if (!line.substr(0, 14).compare("element vertex")) {
                 vertex_count = stoi(line.substr(15));
-                cout << "There are " << vertex_count << " vertices" << endl;
+                if (!quiet) cout << "There are " << vertex_count << " vertices" << endl;
             }//endif
 
             // Checks face count
             if (!line.substr(0, 12).compare("element face")) {
                 face_count = stoi(line.substr(13));
-                cout << "There are " << face_count << " faces." << endl;
+                if (!quiet) cout << "There are " << face_count << " faces." << endl;
             }//endif
 
             // Starts reading for vertex and face information if "end_header" reached
@@ -4,6 +4,6 @@
 #include <fstream>
 using namespace std;
 
-bool ply_to_embedding(string file_name, vector<vector<double>>& vertices, vector<vector<int>>& faces);
+bool ply_to_embedding(string file_name, vector<vector<double>>& vertices, vector<vector<int>>& faces, bool quiet = false);
 
 #endif //RATS_PLY_TO_EMBEDDING_H
@@ -0,0 +1,478 @@
+#include <vector>
+#include <deque>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stop_token>
+#include <functional>
+#include <algorithm>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+
+#ifdef USE_OPENMP
+#include <omp.h>
+#endif
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+using namespace std;
+
+mutex console_lock;
+
+/*
+ * Constructor
+ *
+ * @param workers Number of threads taking subtrees from the pool
+ * @param limit A-trails without crossing staples wanted per face color
+ * @param stop_first Whether the first A-trail without crossing staples finishes both colors
+ */
+Search_Pool::Search_Pool(int workers, int limit, bool stop_first) : workers(workers), limit(limit), stop_first(stop_first) {
+}
+
+/*
+ * Queues an open subtree
+ *
+ * @param task Open subtree
+ */
+void Search_Pool::push(Search_Task& task) {
+    lock_guard<mutex> guard(lock);
+    tasks.push_back(task);
+    hungry = idle + wanted > (int)tasks.size();
+    changed.notify_one();
+}
+
+/*
+ * Takes the oldest (largest) open subtree, waiting while other threads may still split one off. With
+ * checkpoints kept, the subtree is recorded as the thread's own until it reports its progress.
+ *
+ * @param task Open subtree taken
+ * @param branchNum Parallel branch number of the thread (-1 if its subtrees are not checkpointed)
+ * @return bool Whether or not a subtree was taken (false once every thread waits and none is queued, unless
+ * the pool is linked to another process)
+ */
+bool Search_Pool::pop(Search_Task& task, int branchNum) {
+    unique_lock<mutex> guard(lock);
+    bool waiting = false;
+    bool recorded = !checkpoint.empty() && branchNum >= 0;
+    if (recorded && branchNum >= frontiers.size()) frontiers.resize(branchNum + 1);
+    while (true) {
+        while (!tasks.empty() && isFinished(tasks.front().color)) {
+            tasks.pop_front();
+        } //endwhile
+        if (!tasks.empty()) {
+            task = tasks.front();
+            tasks.pop_front();
+            if (waiting) --idle;
+            hungry = idle + wanted > (int)tasks.size();
+            if (recorded) {
+                frontiers[branchNum] = {task};
+                guard.unlock();
+                writeCheckpoint();
+            } //endif
+            return true;
+        } //endif
+        if (!waiting) {
+            ++idle;
+            waiting = true;
+            if (idle == workers) changed.notify_all(); // The last thread to run out wakes the others to stop
+        } //endif
+        hungry = idle + wanted > (int)tasks.size();
+        if (idle == workers && !linked) {
+            if (recorded) frontiers[branchNum].clear();
+            return false;
+        } //endif
+        changed.wait(guard);
+    } //endwhile
+}
+
+/*
+ * Marks a face color finished, dropping its queued subtrees
+ *
+ * @param color Face color
+ */
+void Search_Pool::finish(int color) {
+    finished[color].request_stop();
+    changed.notify_all();
+}
+
+/*
+ * Counts an A-trail without crossing staples, finishing its face color (or both) once enough are routed
+ *
+ * @param color Face color
+ * @return bool Whether or not the A-trail is still wanted (false if the color was finished before it)
+ */
+bool Search_Pool::solve(int color) {
+    lock_guard<mutex> guard(lock);
+    if (isFinished(color)) {
+        return false;
+    } //endif
+    if (++solutions[color] >= limit || stop_first) finish(color);
+    if (stop_first) finish((color + 1) % 2);
+    return true;
+}
+
+/*
+ * Checks whether threads are waiting for subtrees
+ *
+ * @return bool Whether or not a searching thread should split off a subtree
+ */
+bool Search_Pool::isHungry() {
+    return hungry.load(memory_order_relaxed);
+}
+
+/*
+ * Checks whether a face color is finished
+ *
+ * @param color Face color
+ * @return bool Whether or not searches of the color can stop
+ */
+bool Search_Pool::isFinished(int color) {
+    return finished[color].stop_requested();
+}
+
+/*
+ * Links the pool to another process that may bring subtrees, or unlinks it (threads waiting with nothing
+ * queued then stop). Subtrees wanted by other processes so far are no longer split off.
+ *
+ * @param linked Whether or not the pool is linked
+ */
+void Search_Pool::link(bool linked) {
+    lock_guard<mutex> guard(lock);
+    this->linked = linked;
+    wanted = 0;
+    hungry = idle + wanted > (int)tasks.size();
+    changed.notify_all();
+}
+
+/*
+ * Asks searching threads to split off a subtree for another process (taken with take())
+ */
+void Search_Pool::want() {
+    lock_guard<mutex> guard(lock);
+    ++wanted;
+    hungry = idle + wanted > (int)tasks.size();
+}
+
+/*
+ * Takes a subtree split off for another process, without waiting
+ *
+ * @param task Open subtree taken
+ * @return bool Whether or not a subtree was wanted and queued
+ */
+bool Search_Pool::take(Search_Task& task) {
+    lock_guard<mutex> guard(lock);
+    while (!tasks.empty() && isFinished(tasks.front().color)) {
+        tasks.pop_front();
+    } //endwhile
+    if (wanted == 0 || tasks.empty()) {
+        return false;
+    } //endif
+    task = tasks.front();
+    tasks.pop_front();
+    --wanted;
+    hungry = idle + wanted > (int)tasks.size();
+    return true;
+}
+
+/*
+ * Takes the oldest open subtree if one is queued, without waiting (for threads shared by several pools)
+ *
+ * @param task Open subtree taken
+ * @return bool Whether or not a subtree was taken
+ */
+bool Search_Pool::tryPop(Search_Task& task) {
+    lock_guard<mutex> guard(lock);
+    while (!tasks.empty() && isFinished(tasks.front().color)) {
+        tasks.pop_front();
+    } //endwhile
+    if (tasks.empty()) {
+        return false;
+    } //endif
+    task = tasks.front();
+    tasks.pop_front();
+    if (wanted > 0) --wanted;
+    hungry = idle + wanted > (int)tasks.size();
+    return true;
+}
+
+/*
+ * Checks whether every thread waits with no subtree queued
+ *
+ * @return bool Whether or not the pool has run out of work
+ */
+bool Search_Pool::isIdle() {
+    lock_guard<mutex> guard(lock);
+    return idle == workers && tasks.empty();
+}
+
+/*
+ * Asks one thread searching a subtree of the pool to hand what is left of it back to the pool and stop
+ */
+void Search_Pool::yield() {
+    lock_guard<mutex> guard(lock);
+    ++yields;
+    yielding = true;
+}
+
+/*
+ * Takes a request to hand a subtree back, if any (polled by searching threads)
+ *
+ * @return bool Whether or not the thread should hand its subtree back
+ */
+bool Search_Pool::release() {
+    if (!yielding) {
+        return false;
+    } //endif
+    lock_guard<mutex> guard(lock);
+    if (yields == 0) {
+        return false;
+    } //endif
+    --yields;
+    yielding = yields > 0;
+    return true;
+}
+
+/*
+ * Checks whether a searching thread was asked to hand its subtree back and has not yet
+ *
+ * @return bool Whether or not a request is pending
+ */
+bool Search_Pool::isYielding() {
+    return yielding;
+}
+
+/*
+ * Counts search nodes of a thread searching a subtree of the pool, as it polls the pool
+ *
+ * @param nodes Search nodes since its last poll
+ */
+void Search_Pool::count(unsigned long long int nodes) {
+    searched += nodes;
+}
+
+/*
+ * Gives the search nodes counted so far, while subtrees are still searched
+ *
+ * @return unsigned long long int Search nodes counted
+ */
+unsigned long long int Search_Pool::getNodeCount() {
+    return searched;
+}
+
+/*
+ * Keeps checkpoints: the queued subtrees and those of each thread are written to a file every few seconds,
+ * one line each as "ver_stack | v choice color branch" (read_checkpoint_tasks() resumes them)
+ *
+ * @param file Checkpoint file
+ */
+void Search_Pool::keepCheckpoints(string file) {
+    lock_guard<mutex> guard(lock);
+    checkpoint = file;
+    frontiers.resize(workers);
+    checkpointDue = 0;
+}
+
+/*
+ * Checks whether the pool keeps checkpoints
+ *
+ * @return bool Whether or not searching threads report their progress to the pool
+ */
+bool Search_Pool::keepsCheckpoints() {
+    lock_guard<mutex> guard(lock);
+    return !checkpoint.empty();
+}
+
+/*
+ * Checks whether the checkpoint file is due, for searching threads to report their progress at their polls
+ *
+ * @return bool Whether or not the last checkpoint file is older than CHECKPOINT_SECONDS
+ */
+bool Search_Pool::isCheckpointDue() {
+    return chrono::steady_clock::now().time_since_epoch().count() >= checkpointDue.load(memory_order_relaxed);
+}
+
+/*
+ * Records the open subtrees a thread still has to search, replacing those it took or reported before
+ *
+ * @param branchNum Parallel branch number of the thread
+ * @param frontier Open subtrees left of its search (subtrees it split off since may be among them)
+ */
+void Search_Pool::report(int branchNum, vector<Search_Task>& frontier) {
+    {
+        lock_guard<mutex> guard(lock);
+        if (checkpoint.empty()) return;
+        if (branchNum >= frontiers.size()) frontiers.resize(branchNum + 1);
+        frontiers[branchNum] = frontier;
+    }
+    writeCheckpoint();
+}
+
+/*
+ * Writes the checkpoint file, if due: queued subtrees first, then those of each thread, leaving out finished
+ * face colors. The file is replaced whole, so a run stopped while writing leaves the last one.
+ */
+void Search_Pool::writeCheckpoint() {
+    lock_guard<mutex> order(writing);
+    vector<Search_Task> open;
+    vector<int> branch;
+    {
+        lock_guard<mutex> guard(lock);
+        if (!isCheckpointDue()) return;
+        checkpointDue = (chrono::steady_clock::now() + chrono::seconds(CHECKPOINT_SECONDS)).time_since_epoch().count();
+        for (auto& task : tasks) {
+            open.push_back(task);
+            branch.push_back(0);
+        } //endfor
+        for (int i = 0; i < frontiers.size(); ++i) {
+            open.insert(open.end(), frontiers[i].begin(), frontiers[i].end());
+            branch.resize(open.size(), i);
+        } //endfor
+    }
+
+    string temporary = checkpoint + ".tmp";
+    ofstream myFile(temporary);
+    for (int k = 0; k < open.size(); ++k) {
+        if (isFinished(open[k].color)) continue;
+        for (auto i : open[k].ver_stack) {
+            myFile << i << " ";
+        } //endfor
+        myFile << "| " << open[k].v << " " << open[k].choice << " " << open[k].color << " " << branch[k] << endl;
+    } //endfor
+    myFile.close();
+    error_code error;
+    filesystem::rename(temporary, checkpoint, error);
+}
+
+/*
+ * Runs branches in parallel, on OpenMP threads if available and on std::jthread workers otherwise
+ *
+ * @param branches Number of branches/threads
+ * @param branch Work of one branch, given its branch number
+ */
+void parallel_branches(int branches, const function<void(int)>& branch) {
+#ifdef USE_OPENMP
+    #pragma omp parallel num_threads(branches)
+    branch(omp_get_thread_num());
+#else
+    vector<jthread> threads;
+    for (int i = 1; i < branches; ++i) {
+        threads.emplace_back(branch, i);
+    } //endfor
+    branch(0);
+#endif
+}
+
+#ifndef USE_OPENMP
+thread_local int engineThreads = 1; // Threads the engines of this thread may use (std::jthread backend)
+#endif
+
+/*
+ * Sets the threads the engines searching a whole color (or counting and listing covering trees) may use from
+ * the calling thread, this thread included: the OpenMP thread count, or the std::jthread workers they start
+ *
+ * @param threads Number of threads
+ */
+void set_engine_threads(int threads) {
+#ifdef USE_OPENMP
+    omp_set_num_threads(threads);
+#else
+    engineThreads = threads;
+#endif
+}
+
+/*
+ * Gives the threads the engines of the calling thread may use, this thread included
+ *
+ * @return int Number of threads
+ */
+int engine_threads() {
+#ifdef USE_OPENMP
+    return omp_get_max_threads();
+#else
+    return engineThreads;
+#endif
+}
+
+/*
+ * Names a checkpoint file of a pool. Every run writes a generation of its own, after the newest one, so that
+ * a resumed run never replaces the checkpoint files it resumes from.
+ *
+ * @param shape Shape name
+ * @param generation Generation number
+ * @return string covering_tree_<shape>_checkpoint_<generation>.txt
+ */
+string checkpoint_file(string shape, int generation) {
+    return "covering_tree_" + shape + "_checkpoint_" + to_string(generation) + ".txt";
+}
+
+/*
+ * Finds the newest generation of the checkpoint files of a shape in the working directory
+ *
+ * @param shape Shape name
+ * @return int Highest generation number (-1 if there is none)
+ */
+int newest_checkpoint(string shape) {
+    string prefix = "covering_tree_" + shape + "_checkpoint_";
+    int newest = -1;
+    for (auto& entry : filesystem::directory_iterator(".")) {
+        string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0 || name.size() <= prefix.size() + 4 || name.substr(name.size() - 4) != ".txt") {
+            continue;
+        } //endif
+        string generation = name.substr(prefix.size(), name.size() - prefix.size() - 4);
+        if (generation.find_first_not_of("0123456789") == string::npos) {
+            newest = max(newest, stoi(generation));
+        } //endif
+    } //endfor
+    return newest;
+}
+
+/*
+ * Lists the cores the process may run on (Linux only)
+ *
+ * @return vector<int> Core numbers (empty if unknown)
+ */
+vector<int> available_cores() {
+    vector<int> cores;
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &allowed)) cores.push_back(c);
+        } //endfor
+    } //endif
+#endif
+    return cores;
+}
+
+/*
+ * Pins the calling thread to one core, branches taking the available cores in turn (Linux only). Memory the
+ * thread touches first afterwards is then placed on the NUMA node of its core.
+ *
+ * @param branchNum Parallel branch number
+ * @param cores Cores the process may run on
+ * @return bool Whether or not the thread was pinned
+ */
+bool pin_branch(int branchNum, vector<int>& cores) {
+#ifdef __linux__
+    if (cores.empty()) {
+        return false;
+    } //endif
+    cpu_set_t core;
+    CPU_ZERO(&core);
+    CPU_SET(cores[branchNum % cores.size()], &core);
+    return sched_setaffinity(0, sizeof(core), &core) == 0;
+#else
+    return false;
+#endif
+}
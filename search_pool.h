@@ -0,0 +1,88 @@
+#ifndef RATS_SEARCH_POOL_H
+#define RATS_SEARCH_POOL_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <chrono>
+#include <climits>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stop_token>
+#include <functional>
+
+using namespace std;
+
+const int CHECKPOINT_SECONDS = 10;      // Seconds between checkpoint files of a pool or of the coordinator
+
+/*
+ * Class to represent the open subtrees of branch-bound searches shared by parallel threads. Threads without
+ * work wait for a subtree; searching threads split one off whenever threads are waiting (work stealing).
+ * A face color is finished once enough of its A-trails without crossing staples are routed (or, if wanted, once
+ * either color has one), and its subtrees are dropped; searching threads poll this to stop early. Only standard
+ * library synchronization is used, so OpenMP threads and std::jthread workers share it alike. A pool linked to
+ * other processes (see distributed_search.h) keeps its threads waiting while idle, and hands subtrees split off
+ * for those processes to the link.
+ * A searching thread can also be asked to hand its whole subtree back and stop, freeing it for other work.
+ * A pool keeping checkpoints writes its queued subtrees and those each thread last reported as one file, so
+ * that no open subtree is lost however the work was split when the run stopped.
+ */
+class Search_Pool {
+private:
+    deque<Search_Task> tasks;
+    mutex lock;                 // Guards tasks, idle and solutions
+    condition_variable_any changed; // Signals subtrees queued, a face color finished, the pool unlinked or every thread waiting
+    int workers;
+    int idle = 0;
+    atomic<bool> hungry = false; // Whether more threads (or linked processes) wait than subtrees are queued
+    stop_source finished[2];    // Stop requested once each face color is finished
+    int solutions[2] = {0, 0};  // A-trails without crossing staples routed for each face color
+    int limit;                  // A-trails without crossing staples wanted per face color
+    bool stop_first;            // Whether the first A-trail without crossing staples finishes both colors
+    bool linked = false;        // Whether another process may still bring subtrees (idle threads keep waiting)
+    int wanted = 0;             // Subtrees wanted by other processes
+    int yields = 0;             // Searching threads asked to hand their subtrees back
+    atomic<bool> yielding = false; // Whether any is
+    atomic<unsigned long long int> searched = 0; // Search nodes counted by searching threads at their polls
+    string checkpoint;          // Checkpoint file ("" for none)
+    vector<vector<Search_Task>> frontiers; // Open subtrees each thread searches, as last taken or reported
+    atomic<long long int> checkpointDue = LLONG_MAX; // Time (steady clock ticks) the next checkpoint file is due
+    mutex writing;              // Orders checkpoint files
+
+public:
+    Search_Pool(int workers, int limit = 1, bool stop_first = false);
+    void push(Search_Task& task);
+    bool pop(Search_Task& task, int branchNum = -1);
+    void finish(int color);
+    bool solve(int color);
+    bool isHungry();
+    bool isFinished(int color);
+    void link(bool linked);
+    void want();
+    bool take(Search_Task& task);
+    bool tryPop(Search_Task& task);
+    bool isIdle();
+    void yield();
+    bool release();
+    bool isYielding();
+    void count(unsigned long long int nodes);
+    unsigned long long int getNodeCount();
+    void keepCheckpoints(string file);
+    bool keepsCheckpoints();
+    bool isCheckpointDue();
+    void report(int branchNum, vector<Search_Task>& frontier);
+    void writeCheckpoint();
+};
+
+extern mutex console_lock; // Console and checkpoint output of parallel branches, with either backend
+
+void parallel_branches(int branches, const function<void(int)>& branch);
+void set_engine_threads(int threads);
+int engine_threads();
+string checkpoint_file(string shape, int generation);
+int newest_checkpoint(string shape);
+vector<int> available_cores();
+bool pin_branch(int branchNum, vector<int>& cores);
+
+#endif //RATS_SEARCH_POOL_H
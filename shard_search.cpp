@@ -0,0 +1,289 @@
+#include <vector>
+#include <string>
+#include <queue>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <filesystem>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "trail_pipeline.h"
+#include "estimate_covering_tree.h"
+#include "shard_search.h"
+
+using namespace std;
+
+/*
+ * Splits an open subtree into its "Yes" and "No" subtrees on the next branching vertex, as the branch-bound
+ * search would search them (the orbit of the vertex is refuted below "No")
+ *
+ * @param instance Reduced covering tree search instance
+ * @param task Open subtree
+ * @param children Open subtrees below the next decision (none if the subtree closes a cycle)
+ * @return bool Whether or not the subtree was split (false if it has no decision left)
+ */
+bool expand_task(Covering_Instance& instance, Search_Task& task, vector<Search_Task>& children) {
+    int vertex_count = instance.vertices.size();
+    int next_v = task.v + 1;
+    if (instance.infeasible) {
+        return false;
+    } //endif
+
+    // Vertex stack, forest and excluded vertices of the subtree
+    vector<int> stack = task.ver_stack;
+    if (task.v != -1 && task.choice == 1) stack.push_back(task.v);
+    Face_Forest forest(instance.face_count, instance.covered_faces);
+    vector<int> forbidden(vertex_count, 0);
+    for (auto i : stack) {
+        if (!forest.canAdd(instance.vertex_faces[i])) {
+            return true;
+        } //endif
+        forest.add(instance.vertex_faces[i]);
+        for (auto u : instance.conflicts[i]) ++forbidden[u];
+    } //endfor
+    for (auto u : task.refuted) ++forbidden[u];
+    if (forest.isTree() || next_v >= vertex_count) {
+        return false;
+    } //endif
+
+    Search_Task no;
+    no.color = task.color;
+    no.v = next_v;
+    no.ver_stack = stack;
+    no.stabilizer = task.stabilizer;
+    no.refuted = task.refuted;
+    if (!forbidden[next_v] && forest.canAdd(instance.vertex_faces[next_v])) {
+        // "Yes" to next vertex, under the automorphisms fixing it
+        Search_Task yes = no;
+        yes.ver_stack.push_back(next_v);
+        yes.stabilizer.clear();
+        for (auto g : task.stabilizer) {
+            if (instance.automorphisms[g][next_v] == next_v) yes.stabilizer.push_back(g);
+            else no.refuted.push_back(instance.automorphisms[g][next_v]);
+        } //endfor
+        sort(no.refuted.begin(), no.refuted.end());
+        no.refuted.erase(unique(no.refuted.begin(), no.refuted.end()), no.refuted.end());
+        children.push_back(yes);
+    } //endif
+    children.push_back(no);
+    return true;
+}
+
+/*
+ * Deals out the open subtrees of both face colors to shards. Subtrees are split, largest estimated first, until
+ * there are SHARD_SUBTREES for each shard, then dealt out largest first to the shard with the least estimated
+ * work. Each shard searches its subtrees in the order of the depth-first search ("Yes" before "No"), so it
+ * reaches covering trees about as soon as the whole search would. Every process given the same instances and
+ * shard count deals out the same subtrees.
+ *
+ * @param instances Reduced covering tree search instances of both face colors
+ * @param splittable Whether or not each face color is searched by the branch-bound search (otherwise its whole
+ * search goes to one shard)
+ * @param shard Shard number (0 to shards - 1)
+ * @param shards Number of shards
+ * @return vector<Search_Task> Open subtrees of the shard
+ */
+vector<Search_Task> shard_tasks(vector<Covering_Instance>& instances, vector<bool>& splittable, int shard, int shards) {
+    vector<Search_Task> tasks;        // Open subtrees (those split are left empty)
+    vector<long double> sizes;        // Estimated search size of each
+    vector<vector<int>> paths;        // Color and children taken from the root to each (depth-first order)
+    priority_queue<pair<long double, int>> largest;
+    auto add = [&](Search_Task& task, vector<int> path) {
+        vector<int> decided = task.ver_stack;
+        sizes.push_back(estimate_search_size(instances[task.color], task.v, decided, SHARD_PROBES, 0));
+        tasks.push_back(task);
+        paths.push_back(path);
+        largest.push({sizes.back(), -(int)(tasks.size() - 1)});
+    };
+
+    vector<Search_Task> assigned;
+    for (int color = 0; color < 2; ++color) {
+        vector<int> empty;
+        Search_Task root = search_task(instances[color], -1, 0, empty);
+        if (splittable[color]) {
+            add(root, {color});
+        }
+        else if (color % shards == shard) {
+            assigned.push_back(root);
+        } //endif
+    } //endfor
+
+    // Largest open subtrees split until there are enough
+    int open = largest.size();
+    while (open < SHARD_SUBTREES * shards && !largest.empty()) {
+        int t = -largest.top().second;
+        largest.pop();
+        vector<Search_Task> children;
+        if (!expand_task(instances[tasks[t].color], tasks[t], children)) {
+            continue;
+        } //endif
+        tasks[t].color = -1; // Split
+        open += children.size() - 1;
+        for (int c = 0; c < children.size(); ++c) {
+            vector<int> path = paths[t];
+            path.push_back(c);
+            add(children[c], path);
+        } //endfor
+    } //endwhile
+
+    // Largest first to the least loaded shard
+    vector<int> order;
+    for (int t = 0; t < tasks.size(); ++t) {
+        if (tasks[t].color != -1) order.push_back(t);
+    } //endfor
+    stable_sort(order.begin(), order.end(), [&sizes](int a, int b) { return sizes[a] > sizes[b]; });
+    vector<long double> loads(shards, 0);
+    vector<int> mine;
+    for (auto t : order) {
+        int s = min_element(loads.begin(), loads.end()) - loads.begin();
+        loads[s] += sizes[t];
+        if (s == shard) mine.push_back(t);
+    } //endfor
+    sort(mine.begin(), mine.end(), [&paths](int a, int b) { return paths[a] < paths[b]; });
+
+    // Colors taken in turn, as both are searched at once
+    vector<vector<int>> by_color(2);
+    for (auto t : mine) {
+        by_color[tasks[t].color].push_back(t);
+    } //endfor
+    for (int i = 0; i < max(by_color[0].size(), by_color[1].size()); ++i) {
+        for (int color = 0; color < 2; ++color) {
+            if (i < by_color[color].size()) assigned.push_back(tasks[by_color[color][i]]);
+        } //endfor
+    } //endfor
+    return assigned;
+}
+
+/*
+ * Name of the result file of a shard
+ *
+ * @param shape Shape name given to every shard
+ * @param shard Shard number
+ * @param shards Number of shards
+ * @return string File name
+ */
+string shard_result_file(string shape, int shard, int shards) {
+    return "shard_result_" + shape + "_" + to_string(shard) + "_of_" + to_string(shards) + ".txt";
+}
+
+/*
+ * Writes the result of a shard whose search is over: search nodes and, for each face color, whether an A-trail
+ * was routed (without crossing staples, or with forced ones) and its file
+ *
+ * @param shape Shape name given to every shard
+ * @param shard Shard number
+ * @param shards Number of shards
+ * @param trails A-trail pipeline of the shard
+ * @param nodes Search nodes of all branches of the shard
+ */
+void write_shard_result(string shape, int shard, int shards, Trail_Pipeline& trails, unsigned long long int nodes) {
+    ofstream myFile(shard_result_file(shape, shard, shards));
+    myFile << "shard " << shard << " " << shards << endl;
+    myFile << "nodes " << nodes << endl;
+    for (int color = 0; color < 2; ++color) {
+        myFile << "color " << color << " " << trails.isRouted(color) << " " << (trails.isRouted(color) ? trails.getTrailFile(color) : "-") << endl;
+    } //endfor
+    myFile.close();
+}
+
+/*
+ * Merges the results of all shards of a search into one summary (shard_summary_<shape>.txt). Shards without a
+ * result (stopped before their search was over) are resumed from their newest checkpoint file, which lists the
+ * subtrees still queued as well as those being searched: the lines of face colors no shard has routed are
+ * gathered into covering_tree_<shape>_merged_checkpoint.txt, which resumes them on any number of branches.
+ *
+ * @param shape Shape name given to every shard
+ * @param shards Number of shards
+ * @return int Exit status (0 if every shard has a result)
+ */
+int merge_shards(string shape, int shards) {
+    vector<int> routed(2, 0);
+    vector<vector<string>> trail_files(2);
+    unsigned long long int nodes = 0;
+    vector<int> missing;
+    for (int shard = 0; shard < shards; ++shard) {
+        ifstream myFile(shard_result_file(shape, shard, shards));
+        if (!myFile.is_open()) {
+            missing.push_back(shard);
+            continue;
+        } //endif
+        string line, key;
+        while (getline(myFile, line)) {
+            istringstream stream(line);
+            stream >> key;
+            if (key == "nodes") {
+                unsigned long long int n;
+                stream >> n;
+                nodes += n;
+            }
+            else if (key == "color") {
+                int color, r;
+                string file;
+                stream >> color >> r >> file;
+                if (r) {
+                    routed[color] = 1;
+                    trail_files[color].push_back(file);
+                } //endif
+            } //endif
+        } //endwhile
+        myFile.close();
+    } //endfor
+
+    // Checkpoint lines of shards without a result, for face colors still without an A-trail
+    int lines = 0;
+    vector<int> unresumable;
+    string merged = "covering_tree_" + shape + "_merged_checkpoint.txt";
+    ofstream mergedFile(merged);
+    for (auto shard : missing) {
+        // Newest checkpoint file of the shard, which lists every subtree it had left (queued or searched)
+        string shard_shape = shape + "_shard" + to_string(shard);
+        int generation = newest_checkpoint(shard_shape);
+        if (generation == -1) {
+            if (!(routed[0] && routed[1])) unresumable.push_back(shard);
+            continue;
+        } //endif
+        ifstream myFile(checkpoint_file(shard_shape, generation));
+        string line;
+        while (getline(myFile, line)) {
+            istringstream stream(line.substr(line.find('|') + 1));
+            int v, choice, color;
+            if (!(stream >> v >> choice >> color) || routed[color]) {
+                continue;
+            } //endif
+            mergedFile << line << endl;
+            ++lines;
+        } //endwhile
+        myFile.close();
+    } //endfor
+    mergedFile.close();
+    if (!lines) {
+        filesystem::remove(merged);
+    } //endif
+
+    // Summary
+    ostringstream summary;
+    summary << "Shards: " << shards - missing.size() << " of " << shards << " finished, " << nodes << " search nodes." << endl;
+    for (int color = 0; color < 2; ++color) {
+        summary << (color ? "Red" : "Blue") << ": " << (routed[color] ? "A-trail routed" : "no A-trail routed");
+        for (auto& file : trail_files[color]) {
+            summary << " " << file;
+        } //endfor
+        summary << endl;
+    } //endfor
+    if (lines) {
+        summary << "Unfinished shards resume from " << merged << " (" << lines << " open subtree(s))." << endl;
+    } //endif
+    for (auto shard : unresumable) {
+        summary << "Shard " << shard << " has neither a result nor checkpoint files, rerun it with --shard=" << shard << "/" << shards << "." << endl;
+    } //endfor
+    ofstream summaryFile("shard_summary_" + shape + ".txt");
+    summaryFile << summary.str();
+    summaryFile.close();
+    cout << summary.str();
+    return missing.empty() ? 0 : 1;
+}
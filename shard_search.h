@@ -0,0 +1,18 @@
+#ifndef RATS_SHARD_SEARCH_H
+#define RATS_SHARD_SEARCH_H
+
+#include <vector>
+#include <string>
+
+using namespace std;
+
+const int SHARD_SUBTREES = 16; // Open subtrees made for each shard before they are dealt out
+const int SHARD_PROBES = 100; // Random probes averaged by the size estimate of each open subtree
+
+bool expand_task(Covering_Instance& instance, Search_Task& task, vector<Search_Task>& children);
+vector<Search_Task> shard_tasks(vector<Covering_Instance>& instances, vector<bool>& splittable, int shard, int shards);
+string shard_result_file(string shape, int shard, int shards);
+void write_shard_result(string shape, int shard, int shards, Trail_Pipeline& trails, unsigned long long int nodes);
+int merge_shards(string shape, int shards);
+
+#endif //RATS_SHARD_SEARCH_H
@@ -0,0 +1,325 @@
+#include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
+
+#include "cc_embedded_graph.h"
+#include "kernelize.h"
+#include "td_covering_tree.h"
+
+using namespace std;
+
+typedef vector<signed char> Labels; // Component of each bag node, -1 if node not chosen
+
+/*
+ * Elimination ordering of the vertex-face incidence graph of an instance, using the minimum degree
+ * heuristic with ties broken by minimum fill. Nodes 0..n-1 are branching vertices and n.. are faces;
+ * face 0 is kept for last since it is added to every bag.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param max_width Width at which to give up
+ * @param order Elimination ordering to be made
+ * @param later Neighbors (including fill) of each node eliminated after it
+ * @return int Width of tree decomposition (max_width + 1 if given up)
+ */
+int td_elimination(Covering_Instance& instance, int max_width, vector<int>& order, vector<vector<int>>& later) {
+    int n = instance.vertices.size();
+    int node_count = n + instance.face_count;
+    int root = n;
+    vector<set<int>> adj(node_count);
+    for (int i = 0; i < n; ++i) {
+        for (auto f : instance.vertex_faces[i]) {
+            adj[i].insert(n + f);
+            adj[n + f].insert(i);
+        } //endfor
+    } //endfor
+
+    order.clear();
+    later = vector<vector<int>>(node_count);
+    vector<bool> eliminated(node_count, false);
+    int width = 0;
+    for (int step = 0; step < node_count - 1; ++step) {
+        int best = -1;
+        int best_degree = 0;
+        long long best_fill = 0;
+        for (int x = 0; x < node_count; ++x) {
+            if (eliminated[x] || x == root) continue;
+            int degree = adj[x].size();
+            if (best != -1 && degree > best_degree) continue;
+            long long fill = 0;
+            for (auto a : adj[x]) {
+                for (auto b : adj[x]) {
+                    if (a < b && adj[a].find(b) == adj[a].end()) ++fill;
+                } //endfor
+            } //endfor
+            if (best == -1 || degree < best_degree || fill < best_fill) {
+                best = x;
+                best_degree = degree;
+                best_fill = fill;
+            } //endif
+        } //endfor
+
+        // Bag is node, its remaining neighbors and the root face
+        int bag_size = best_degree + 1 + (adj[best].count(root) ? 0 : 1);
+        width = max(width, bag_size - 1);
+        if (width > max_width) {
+            return max_width + 1;
+        } //endif
+
+        order.push_back(best);
+        eliminated[best] = true;
+        later[best] = vector<int>(adj[best].begin(), adj[best].end());
+        for (auto a : adj[best]) {
+            adj[a].erase(best);
+            for (auto b : adj[best]) {
+                if (a != b) adj[a].insert(b);
+            } //endfor
+        } //endfor
+        adj[best].clear();
+    } //endfor
+    order.push_back(root);
+    return width;
+}
+
+/*
+ * Estimates treewidth of the vertex-face incidence graph of an instance
+ *
+ * @param instance Reduced covering tree search instance
+ * @param max_width Width at which to stop estimating
+ * @return int Width of heuristic tree decomposition (max_width + 1 if larger)
+ */
+int td_width(Covering_Instance& instance, int max_width) {
+    vector<int> order;
+    vector<vector<int>> later;
+    if (instance.infeasible || instance.face_count <= 1) {
+        return 0;
+    } //endif
+    return td_elimination(instance, max_width, order, later);
+}
+
+/*
+ * Relabels components in order of first appearance
+ *
+ * @param labels Components of bag nodes
+ */
+void td_canonical(Labels& labels) {
+    signed char relabel[128];
+    fill_n(relabel, 128, -1);
+    signed char next = 0;
+    for (auto& l : labels) {
+        if (l < 0) continue;
+        if (relabel[l] < 0) relabel[l] = next++;
+        l = relabel[l];
+    } //endfor
+}
+
+/*
+ * Joins two components of bag nodes
+ *
+ * @param labels Components of bag nodes
+ * @param a First component
+ * @param b Second component
+ */
+void td_merge(Labels& labels, signed char a, signed char b) {
+    for (auto& l : labels) {
+        if (l == b) l = a;
+    } //endfor
+}
+
+/*
+ * Decides whether a covering tree exists by dynamic programming over a tree decomposition of the
+ * vertex-face incidence graph. Each bag keeps which of its vertices are chosen and how its chosen nodes are
+ * partitioned into components of the forest below it; a component that can no longer grow is rejected.
+ *
+ * @param instance Reduced covering tree search instance
+ * @param ver_stack Covering tree vertices (branching vertices of instance) to be found
+ * @return bool Whether or not a covering tree exists
+ */
+bool td_covering_tree(Covering_Instance& instance, vector<int>& ver_stack) {
+    int n = instance.vertices.size();
+    if (instance.infeasible) {
+        return false;
+    } //endif
+    if (instance.face_count <= 1) {
+        if (!instance.covered_faces.empty()) return true;
+        if (n == 0) return false;
+        ver_stack.push_back(0);
+        return true;
+    } //endif
+
+    vector<int> order;
+    vector<vector<int>> later;
+    td_elimination(instance, instance.vertices.size() + instance.face_count, order, later);
+    int node_count = order.size();
+    int root = n;
+    vector<int> position(node_count);
+    for (int i = 0; i < node_count; ++i) {
+        position[order[i]] = i;
+    } //endfor
+
+    // Incidence edges introduced at whichever endpoint is eliminated first
+    vector<vector<int>> edges(node_count);
+    for (int i = 0; i < n; ++i) {
+        for (auto f : instance.vertex_faces[i]) {
+            if (position[i] < position[n + f]) edges[i].push_back(n + f);
+            else edges[n + f].push_back(i);
+        } //endfor
+    } //endfor
+
+    // Tree decomposition: parent bag of each node is its earliest eliminated later neighbor
+    vector<vector<int>> children(node_count);
+    for (auto x : order) {
+        if (x == root) continue;
+        int parent = root;
+        for (auto y : later[x]) {
+            if (position[y] < position[parent]) parent = y;
+        } //endfor
+        children[parent].push_back(x);
+    } //endfor
+
+    // Tables before forgetting (with choices of children states) and after forgetting each node
+    vector<vector<int>> bags(node_count);
+    vector<vector<Labels>> pre_states(node_count);
+    vector<vector<vector<int>>> pre_children(node_count);
+    vector<vector<Labels>> post_states(node_count);
+    vector<vector<int>> post_pre(node_count);
+
+    for (auto x : order) {
+        vector<int> bag = later[x];
+        if (x != root && find(bag.begin(), bag.end(), root) == bag.end()) bag.push_back(root);
+        bag.push_back(x);
+        sort(bag.begin(), bag.end());
+        bags[x] = bag;
+        int k = bag.size();
+
+        // Every node introduced on its own
+        map<Labels, vector<int>> table;
+        vector<int> free_vertices;
+        for (int j = 0; j < k; ++j) {
+            if (bag[j] < n) free_vertices.push_back(j);
+        } //endfor
+        for (int mask = 0; mask < (1 << free_vertices.size()); ++mask) {
+            Labels labels(k);
+            for (int j = 0; j < k; ++j) labels[j] = j;
+            for (int b = 0; b < free_vertices.size(); ++b) {
+                if (!((mask >> b) & 1)) labels[free_vertices[b]] = -1;
+            } //endfor
+            td_canonical(labels);
+            table[labels] = {};
+        } //endfor
+
+        // Join tables of children
+        for (auto c : children[x]) {
+            vector<int> where;
+            for (auto y : bags[c]) {
+                if (y != c) where.push_back(lower_bound(bag.begin(), bag.end(), y) - bag.begin());
+            } //endfor
+            map<vector<bool>, vector<int>> by_choice;
+            for (int s = 0; s < post_states[c].size(); ++s) {
+                vector<bool> chosen;
+                for (auto l : post_states[c][s]) chosen.push_back(l >= 0);
+                by_choice[chosen].push_back(s);
+            } //endfor
+
+            map<Labels, vector<int>> joined;
+            for (auto& [labels, choices] : table) {
+                vector<bool> chosen;
+                for (auto j : where) chosen.push_back(labels[j] >= 0);
+                auto it = by_choice.find(chosen);
+                if (it == by_choice.end()) continue;
+                for (auto s : it->second) {
+                    Labels merged = labels;
+                    Labels& child = post_states[c][s];
+                    bool acyclic = true;
+                    signed char first[128];
+                    fill_n(first, 128, -1);
+                    for (int j = 0; j < where.size() && acyclic; ++j) {
+                        if (child[j] < 0) continue;
+                        signed char a = merged[where[j]];
+                        if (first[child[j]] < 0) {
+                            first[child[j]] = a;
+                        }
+                        else if (merged[where[j]] == first[child[j]]) {
+                            acyclic = false;
+                        }
+                        else {
+                            signed char b = first[child[j]];
+                            td_merge(merged, b, a);
+                            for (auto& fl : first) {
+                                if (fl == a) fl = b;
+                            } //endfor
+                        } //endif
+                    } //endfor
+                    if (!acyclic) continue;
+                    td_canonical(merged);
+                    if (joined.find(merged) == joined.end()) {
+                        vector<int> next_choices = choices;
+                        next_choices.push_back(s);
+                        joined[merged] = next_choices;
+                    } //endif
+                } //endfor
+            } //endfor
+            table = joined;
+        } //endfor
+
+        // Introduce incidences of node, then forget it
+        int xj = lower_bound(bag.begin(), bag.end(), x) - bag.begin();
+        map<Labels, int> post_index;
+        for (auto& [labels, choices] : table) {
+            Labels edged = labels;
+            bool acyclic = true;
+            for (auto y : edges[x]) {
+                int yj = lower_bound(bag.begin(), bag.end(), y) - bag.begin();
+                if (edged[xj] < 0 || edged[yj] < 0) continue;
+                if (edged[xj] == edged[yj]) {
+                    acyclic = false;
+                    break;
+                } //endif
+                td_merge(edged, edged[xj], edged[yj]);
+            } //endfor
+            if (!acyclic) continue;
+
+            // Component of forgotten node must reach a later bag node (the root face is in every bag)
+            if (edged[xj] >= 0 && x != root) {
+                bool reaches = false;
+                for (int j = 0; j < k; ++j) {
+                    if (j != xj && edged[j] == edged[xj]) reaches = true;
+                } //endfor
+                if (!reaches) continue;
+            } //endif
+
+            pre_states[x].push_back(labels);
+            pre_children[x].push_back(choices);
+            Labels forgotten = edged;
+            forgotten.erase(forgotten.begin() + xj);
+            td_canonical(forgotten);
+            if (post_index.find(forgotten) == post_index.end()) {
+                post_index[forgotten] = post_states[x].size();
+                post_states[x].push_back(forgotten);
+                post_pre[x].push_back(pre_states[x].size() - 1);
+            } //endif
+        } //endfor
+    } //endfor
+
+    if (post_states[root].empty()) {
+        return false;
+    } //endif
+
+    // Extract witness top-down from root
+    vector<pair<int, int>> pending = {{root, post_pre[root][0]}};
+    vector<bool> chosen(n, false);
+    while (!pending.empty()) {
+        auto [x, p] = pending.back();
+        pending.pop_back();
+        int xj = lower_bound(bags[x].begin(), bags[x].end(), x) - bags[x].begin();
+        if (x < n && pre_states[x][p][xj] >= 0) chosen[x] = true;
+        for (int c = 0; c < children[x].size(); ++c) {
+            int child = children[x][c];
+            pending.push_back({child, post_pre[child][pre_children[x][p][c]]});
+        } //endfor
+    } //endwhile
+    for (int i = 0; i < n; ++i) {
+        if (chosen[i]) ver_stack.push_back(i);
+    } //endfor
+    return true;
+}
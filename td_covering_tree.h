@@ -0,0 +1,13 @@
+#ifndef RATS_TD_COVERING_TREE_H
+#define RATS_TD_COVERING_TREE_H
+
+#include <vector>
+
+using namespace std;
+
+const int TD_MAX_WIDTH = 8; // Widest tree decomposition the dynamic programming engine is used for
+
+int td_width(Covering_Instance& instance, int max_width);
+bool td_covering_tree(Covering_Instance& instance, vector<int>& ver_stack);
+
+#endif //RATS_TD_COVERING_TREE_H
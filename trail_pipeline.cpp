@@ -0,0 +1,212 @@
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <iostream>
+#include <sstream>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <stop_token>
+#include <condition_variable>
+
+#include "cc_embedded_graph.h"
+#include "face_forest.h"
+#include "kernelize.h"
+#include "bb_covering_tree.h"
+#include "search_pool.h"
+#include "find_a_trail.h"
+#include "trail_pipeline.h"
+
+using namespace std;
+
+const int QUEUED_PER_WORKER = 4; // Covering trees queued per trail worker before searching threads wait
+
+/*
+ * Constructor: starts the trail workers and the writer thread
+ *
+ * @param eg Embedded graph
+ * @param adjL Vertex-to-edge adjacency list
+ * @param instances Reduced covering tree search instances of both face colors
+ * @param pool Work pool of the searches, counting A-trails without crossing staples
+ * @param worker_count Number of trail workers
+ */
+Trail_Pipeline::Trail_Pipeline(CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, vector<Covering_Instance>& instances, Search_Pool& pool, int worker_count)
+        : eg(&eg), adjL(&adjL), instances(&instances), pool(&pool), capacity(QUEUED_PER_WORKER * max(1, worker_count)) {
+    for (int i = 0; i < max(1, worker_count); ++i) {
+        workers.emplace_back([this](stop_token stop) { route(stop); });
+    } //endfor
+    writer = jthread([this](stop_token stop) { write(stop); });
+}
+
+/*
+ * Destructor: finishes the covering trees handed over
+ */
+Trail_Pipeline::~Trail_Pipeline() {
+    close();
+}
+
+/*
+ * Hands a covering tree over for A-trail routing, waiting while too many are queued
+ *
+ * @param job Covering tree found (color, branch, name and vertex stack set)
+ */
+void Trail_Pipeline::submit(Trail_Job& job) {
+    {
+        unique_lock<mutex> guard(lock);
+        space.wait(guard, [this] { return (int)candidates.size() < capacity; });
+        candidates.push_back(move(job));
+    }
+    ready.notify_all();
+}
+
+/*
+ * Routes, checks and writes every covering tree handed over, then stops the threads (no more may be handed over)
+ */
+void Trail_Pipeline::close() {
+    for (auto& worker : workers) {
+        worker.request_stop();
+    } //endfor
+    for (auto& worker : workers) {
+        if (worker.joinable()) worker.join();
+    } //endfor
+    writer.request_stop();
+    if (writer.joinable()) writer.join();
+}
+
+/*
+ * Checks whether a face color has a wanted A-trail routed
+ *
+ * @param color Face color
+ * @return bool Whether or not an A-trail without crossing staples (or with forced ones) was routed
+ */
+bool Trail_Pipeline::isRouted(int color) {
+    return routed[color];
+}
+
+/*
+ * Gives the first A-trail file of a face color without crossing staples (or with forced ones)
+ *
+ * @param color Face color
+ * @return string A-trail file name (empty if none was routed)
+ */
+string Trail_Pipeline::getTrailFile(int color) {
+    lock_guard<mutex> guard(lock);
+    return trail_files[color].empty() ? "" : trail_files[color].front();
+}
+
+/*
+ * Gives every A-trail file of a face color without crossing staples (or with forced ones), in routing order
+ *
+ * @param color Face color
+ * @return vector<string> A-trail file names
+ */
+vector<string> Trail_Pipeline::getTrailFiles(int color) {
+    lock_guard<mutex> guard(lock);
+    return trail_files[color];
+}
+
+/*
+ * Trail worker: routes A-trails along queued covering trees and checks them for crossing staples, until
+ * stopped with nothing queued
+ *
+ * @param stop Stop token of the worker
+ */
+void Trail_Pipeline::route(stop_token stop) {
+    while (true) {
+        Trail_Job job;
+        {
+            unique_lock<mutex> guard(lock);
+            ready.wait(guard, stop, [this] { return !candidates.empty(); });
+            if (candidates.empty()) {
+                return;
+            } //endif
+            job = move(candidates.front());
+            candidates.pop_front();
+        }
+        space.notify_all();
+
+        // Covering trees of a face color finished meanwhile are not routed
+        if (!job.forced && pool->isFinished(job.color)) {
+            continue;
+        } //endif
+
+        // Covering tree vertices and A-trail
+        map_to_original((*instances)[job.color], job.ver_stack, job.ver_choice);
+        if (!job.ver_choice.empty()) {
+            find_ATrail(*eg, job.a_trail, job.ver_choice, job.color, job.name);
+            job.crossing_staples = check_crossing_staples(*adjL, job.a_trail);
+        } //endif
+
+        // A-trails without crossing staples beyond those wanted are dropped
+        bool wanted = job.forced;
+        if (!job.forced && !job.crossing_staples) {
+            if (!pool->solve(job.color)) {
+                continue;
+            } //endif
+            wanted = true;
+        }
+        else if (!job.forced && pool->isFinished(job.color)) {
+            continue;
+        } //endif
+
+        {
+            lock_guard<mutex> guard(lock);
+            if (wanted) {
+                job.solution = true;
+                routed[job.color] = 1;
+            } //endif
+            results.push_back(move(job));
+        }
+        ready.notify_all();
+    } //endwhile
+}
+
+/*
+ * Writer thread: writes A-trail files and reports covering trees to console, until stopped with nothing queued
+ *
+ * @param stop Stop token of the writer
+ */
+void Trail_Pipeline::write(stop_token stop) {
+    while (true) {
+        Trail_Job job;
+        {
+            unique_lock<mutex> guard(lock);
+            ready.wait(guard, stop, [this] { return !results.empty(); });
+            if (results.empty()) {
+                return;
+            } //endif
+            job = move(results.front());
+            results.pop_front();
+        }
+
+        // A-trail
+        if (!job.a_trail.empty()) {
+            write_atrail_to_file(job.a_trail, job.color, job.name, job.crossing_staples);
+        } //endif
+        if (job.solution) {
+            lock_guard<mutex> guard(lock);
+            trail_files[job.color].push_back(job.name + (job.color ? "_red" : "_blue") + (job.crossing_staples ? "_crossing_staples.txt" : "_no_crossing_staples.txt"));
+        } //endif
+
+        // Output vertex stack and covering tree vertices to console
+        ostringstream found;
+        found << endl;
+        found << "Covering tree found ..." << endl;
+        found << "Vertex stack (" << (job.color ? "red" : "blue") << ") branch " << job.branchNum << ": ";
+        for (auto u: job.ver_stack) {
+            found << u << " ";
+        } //endfor
+        found << endl;
+        found << "Covering tree vertices (" << (job.color ? "red" : "blue") << ") branch " << job.branchNum << ": ";
+        for (auto u: job.ver_choice) {
+            found << u << " ";
+        } //endfor
+        found << endl;
+        found << (job.crossing_staples ? "A-trail has crossing staples." : "A-trail has no crossing staples.") << endl;
+        {
+            lock_guard<mutex> guard(console_lock);
+            cout << found.str() << flush;
+        }
+    } //endwhile
+}
@@ -0,0 +1,69 @@
+#ifndef RATS_TRAIL_PIPELINE_H
+#define RATS_TRAIL_PIPELINE_H
+
+#include <vector>
+#include <deque>
+#include <map>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <stop_token>
+#include <condition_variable>
+
+using namespace std;
+
+const int BRANCHES_PER_TRAIL_WORKER = 8; // Search branches served by each A-trail worker
+
+/*
+ * Covering tree found by a search, on its way through A-trail routing and output
+ */
+struct Trail_Job {
+    int color = 0;
+    int branchNum = 0;
+    string name;                    // Name for A-trail output files
+    bool forced = false;            // Whether every A-trail of the color has crossing staples (only this one is routed)
+    vector<int> ver_stack;          // Covering tree vertices (branching vertices of instance)
+    vector<int> ver_choice;         // Covering tree vertices of the mesh
+    vector<Edge> a_trail;
+    bool crossing_staples = false;
+    bool solution = false;          // Whether the A-trail counts for the face color (its file is reported once written)
+};
+
+/*
+ * Class to represent the A-trail pipeline behind the covering tree searches. Searching threads hand covering
+ * trees over and keep searching; a few trail workers route and check their A-trails, and one writer thread
+ * writes A-trail files and console output. An A-trail without crossing staples is counted by the search pool
+ * as soon as it is checked, so searches of a finished face color stop at their next poll of the pool.
+ */
+class Trail_Pipeline {
+private:
+    CC_Embedded_Graph* eg;
+    map<int, vector<int>>* adjL;
+    vector<Covering_Instance>* instances;
+    Search_Pool* pool;
+    deque<Trail_Job> candidates;    // Covering trees waiting for A-trail routing
+    deque<Trail_Job> results;       // Routed A-trails waiting to be written
+    mutex lock;                     // Guards candidates and results
+    condition_variable_any ready;   // Signals candidates or results queued
+    condition_variable_any space;   // Signals candidates taken
+    int capacity;                   // Most candidates queued before searching threads wait
+    atomic<int> routed[2] = {0, 0}; // Whether each face color has an A-trail routed without crossing staples (or with forced ones)
+    vector<string> trail_files[2];  // Files of such A-trails of each face color, once written
+    vector<jthread> workers;
+    jthread writer;
+
+    void route(stop_token stop);
+    void write(stop_token stop);
+
+public:
+    Trail_Pipeline(CC_Embedded_Graph& eg, map<int, vector<int>>& adjL, vector<Covering_Instance>& instances, Search_Pool& pool, int worker_count);
+    ~Trail_Pipeline();
+    void submit(Trail_Job& job);
+    void close();
+    bool isRouted(int color);
+    string getTrailFile(int color);
+    vector<string> getTrailFiles(int color);
+};
+
+#endif //RATS_TRAIL_PIPELINE_H